@@ -0,0 +1,510 @@
+// File:    BatchJob.cpp
+// Author:  Hazael Magino
+// Date:    10/19/2026
+// Section: Section 12
+// E-mail:  hazaelm1@umbc.edu
+// Description: Streaming batch run with checkpoint and resume. A checkpoint is only
+// written after the output has been flushed and fsynced up to the offset it records,
+// and it replaces the previous one with an atomic rename, so after a crash the
+// checkpoint on disk always describes output that really exists. On restart the
+// output is cut back to that offset and the input is resumed at the matching record.
+
+#include <string>
+#include <vector>
+#include <sstream>
+#include <fstream>
+#include <iostream>
+#include <chrono>
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "BatchJob.h"
+#include "SequencerCore.h"
+#include "GzipReader.h"
+#include "Protein.h"
+
+using namespace std;
+
+const size_t BATCH_CHUNK = 1 << 20; //Bytes read from a plain input file at a time
+const int CHECKPOINT_VERSION = 1; //Format of the checkpoint file
+
+  // Name: BatchJob (constructor)
+  // Desc: Prepares a batch run of fileName into outFile; the checkpoint is kept in
+  //       outFile + ".ckpt" and written at most every checkpointSeconds seconds
+  // Preconditions: None
+  // Postconditions: Nothing is read until Run
+BatchJob::BatchJob(string fileName, string outFile, int checkpointSeconds, int threads,
+                   const function<int(const string &)> &codeFor){
+
+  m_fileName = fileName;
+
+  m_outFile = outFile;
+
+  m_checkpointFile = outFile + ".ckpt";
+
+  m_checkpointSeconds = max(checkpointSeconds, 0);
+
+  m_threads = max(threads, 1);
+
+  m_codeFor = codeFor;
+
+  m_progress = {fileName, 0, 0, 0, 0, 0, 0};
+
+  m_resumedFrom = 0;
+
+  m_output = nullptr;
+
+}
+
+  // Name: Run
+  // Desc: Resumes from the checkpoint if there is one (truncating the output to the
+  //       checkpointed offset), then processes every remaining record
+  // Preconditions: None
+  // Postconditions: Returns true once the whole input is done and the checkpoint
+  //                 is removed; otherwise false with error set
+bool BatchJob::Run(string &error){
+
+  struct stat info;
+
+  if(stat(m_fileName.c_str(), &info) != 0){
+
+    error = "error reading " + m_fileName;
+
+    return false;
+  }
+
+  m_progress.m_inputSize = info.st_size;
+
+  if(!LoadCheckpoint(error)){
+
+    return false;
+  }
+
+  m_resumedFrom = m_progress.m_records;
+
+  // Anything written after the checkpoint is redone, so it is cut off first
+
+  if(m_progress.m_inputOffset > 0){
+
+    struct stat outInfo;
+
+    if((stat(m_outFile.c_str(), &outInfo) != 0) || (uint64_t(outInfo.st_size) < m_progress.m_outputOffset)){
+
+      error = m_outFile + " is shorter than its checkpoint; delete " + m_checkpointFile + " to start over";
+
+      return false;
+    }
+
+    if(truncate(m_outFile.c_str(), m_progress.m_outputOffset) != 0){
+
+      error = "cannot truncate " + m_outFile + ": " + strerror(errno);
+
+      return false;
+    }
+  }
+
+  m_output = fopen(m_outFile.c_str(), (m_progress.m_inputOffset > 0) ? "ab" : "wb");
+
+  if(m_output == nullptr){
+
+    error = "error opening " + m_outFile;
+
+    return false;
+  }
+
+  uint64_t resumeOffset = m_progress.m_inputOffset;
+
+  uint64_t streamOffset = 0; // offset of the next byte fed to the sink
+
+  string pending = "";
+
+  uint64_t pendingOffset = 0;
+
+  vector<char> scratch;
+
+  string name;
+
+  string fasta;
+
+  bool failed = false;
+
+  auto lastCheckpoint = chrono::steady_clock::now();
+
+  // Processes one line that starts at offset and whose successor starts at next
+
+  auto handleLine = [&](const char *line, size_t length, uint64_t offset, uint64_t next){
+
+    if(offset < resumeOffset){
+
+      return;
+    }
+
+    int status = ConvertRecord(line, length, m_codeFor, scratch, name, fasta);
+
+    if(status == CORE_OK){
+
+      if(fwrite(fasta.data(), 1, fasta.length(), m_output) != fasta.length()){
+
+        error = "error writing " + m_outFile;
+
+        failed = true;
+
+        return;
+      }
+
+      m_progress.m_proteins++;
+
+      m_progress.m_outputOffset += fasta.length();
+
+    }else if(status == CORE_INVALID_BASE){
+
+      cout << "Skipping DNA (" << name << "): " << CoreStatusMessage(status) << endl;
+
+      m_progress.m_skipped++;
+    }
+
+    if(status != CORE_BAD_ARGUMENT){
+
+      m_progress.m_records++;
+    }
+
+    m_progress.m_inputOffset = next;
+
+    if(chrono::steady_clock::now() - lastCheckpoint >= chrono::seconds(m_checkpointSeconds)){
+
+      if(!SaveCheckpoint()){
+
+        error = "error writing " + m_checkpointFile;
+
+        failed = true;
+      }
+
+      lastCheckpoint = chrono::steady_clock::now();
+    }
+  };
+
+  TextSink sink = [&](const char *data, size_t length){
+
+    const char *start = data;
+
+    const char *stop = data + length;
+
+    while((data < stop) && !failed){
+
+      const char *lineEnd = (const char *)memchr(data, '\n', stop - data);
+
+      uint64_t offset = streamOffset + (data - start);
+
+      if(lineEnd == nullptr){
+
+        if(pending.empty()){
+
+          pendingOffset = offset;
+        }
+
+        pending.append(data, stop - data);
+
+        break;
+      }
+
+      uint64_t next = streamOffset + (lineEnd + 1 - start);
+
+      if(pending.empty()){
+
+        handleLine(data, lineEnd - data, offset, next);
+
+      }else{
+
+        pending.append(data, lineEnd - data);
+
+        handleLine(pending.data(), pending.length(), pendingOffset, next);
+
+        pending.clear();
+      }
+
+      data = lineEnd + 1;
+    }
+
+    streamOffset += length;
+  };
+
+  if(GzipReader::IsCompressed(m_fileName)){
+
+    // A compressed stream has to be inflated from the start; records before the
+    // checkpoint are only skipped, not transcribed or translated again
+
+    string readError = "";
+
+    if(!GzipReader::Read(m_fileName, m_threads, sink, readError) && !failed){
+
+      error = "error reading file: " + readError;
+
+      failed = true;
+    }
+
+  }else{
+
+    ifstream inputData(m_fileName, ios::binary);
+
+    if(!inputData.is_open()){
+
+      error = "error reading " + m_fileName;
+
+      failed = true;
+
+    }else{
+
+      inputData.seekg(resumeOffset);
+
+      streamOffset = resumeOffset;
+
+      vector<char> buffer(BATCH_CHUNK);
+
+      while(!failed && (inputData.read(buffer.data(), BATCH_CHUNK) || (inputData.gcount() > 0))){
+
+        sink(buffer.data(), inputData.gcount());
+      }
+    }
+  }
+
+  // The last record may not end with a line break
+
+  if(!failed && !pending.empty()){
+
+    handleLine(pending.data(), pending.length(), pendingOffset, streamOffset);
+  }
+
+  if(fclose(m_output) != 0){
+
+    error = "error writing " + m_outFile;
+
+    failed = true;
+  }
+
+  m_output = nullptr;
+
+  if(failed){
+
+    return false;
+  }
+
+  // The job is complete; a leftover checkpoint would make the next run skip everything
+
+  remove(m_checkpointFile.c_str());
+
+  return true;
+
+}
+
+  // Name: GetProgress
+  // Preconditions: None
+  // Postconditions: Returns the current progress counters
+const BatchCheckpoint &BatchJob::GetProgress(){
+
+  return m_progress;
+
+}
+
+  // Name: GetResumedFrom
+  // Preconditions: Run has been called
+  // Postconditions: Returns the records that were already done when Run started
+uint64_t BatchJob::GetResumedFrom(){
+
+  return m_resumedFrom;
+
+}
+
+  // Name: ConvertRecord (static)
+  // Desc: Parses one "name,bases" line (commas and carriage returns between bases
+  //       are skipped), transcribes it and translates the mRNA as FASTA
+  // Preconditions: line is one record without its line break
+  // Postconditions: Returns CORE_OK with fasta set, CORE_INVALID_BASE if the strand
+  //                 cannot be transcribed, or CORE_BAD_ARGUMENT if the line is not
+  //                 a record; name is set whenever the line is a record
+int BatchJob::ConvertRecord(const char *line, size_t length, const function<int(const string &)> &codeFor,
+                            vector<char> &scratch, string &name, string &fasta){
+
+  const char *comma = (const char *)memchr(line, ',', length);
+
+  if(comma == nullptr){
+
+    return CORE_BAD_ARGUMENT;
+  }
+
+  name.assign(line, comma - line);
+
+  // Same record rules as Sequencer::AddRecord
+
+  string bases;
+
+  bases.reserve((length - name.length()) / 2 + 1);
+
+  for(const char *curr = comma + 1; curr < line + length; curr++){
+
+    if((*curr != ',') && (*curr != '\r')){
+
+      bases += *curr;
+    }
+  }
+
+  scratch.resize(bases.length());
+
+  BaseSpan dna = {bases.data(), bases.length()};
+
+  OutputSpan mRNA = {scratch.data(), scratch.size(), 0};
+
+  int status = CoreTranscribe(dna, mRNA);
+
+  if(status != CORE_OK){
+
+    return status;
+  }
+
+  // The strand is never stored, so the protein has no source index
+
+  Protein *protein = Protein::Translate(name, -1, scratch.data(), mRNA.m_length, codeFor(name));
+
+  ostringstream record;
+
+  protein->WriteFasta(record);
+
+  delete protein;
+
+  fasta = record.str();
+
+  return CORE_OK;
+
+}
+
+  // Name: LoadCheckpoint
+  // Desc: Reads the checkpoint file if it exists
+  // Preconditions: None
+  // Postconditions: Returns false with error set if a checkpoint exists but is
+  //                 damaged or belongs to another input; m_progress is set
+bool BatchJob::LoadCheckpoint(string &error){
+
+  ifstream inputData(m_checkpointFile);
+
+  if(!inputData.is_open()){
+
+    return true;
+  }
+
+  string header;
+
+  int version = 0;
+
+  BatchCheckpoint saved = {"", 0, 0, 0, 0, 0, 0};
+
+  inputData >> header >> version;
+
+  if((header != "sequencer-checkpoint") || (version != CHECKPOINT_VERSION)){
+
+    error = m_checkpointFile + " is not a checkpoint";
+
+    return false;
+  }
+
+  string key;
+
+  while(inputData >> key){
+
+    if(key == "input"){
+
+      // The file name is last and may contain spaces
+
+      inputData >> ws;
+
+      getline(inputData, saved.m_input);
+
+    }else if(key == "input_size"){
+      inputData >> saved.m_inputSize;
+    }else if(key == "input_offset"){
+      inputData >> saved.m_inputOffset;
+    }else if(key == "records"){
+      inputData >> saved.m_records;
+    }else if(key == "proteins"){
+      inputData >> saved.m_proteins;
+    }else if(key == "skipped"){
+      inputData >> saved.m_skipped;
+    }else if(key == "output_offset"){
+      inputData >> saved.m_outputOffset;
+    }
+  }
+
+  if((saved.m_input != m_progress.m_input) || (saved.m_inputSize != m_progress.m_inputSize)){
+
+    error = m_checkpointFile + " belongs to another input; delete it to start over";
+
+    return false;
+  }
+
+  m_progress = saved;
+
+  return true;
+
+}
+
+  // Name: SaveCheckpoint
+  // Desc: Makes the output durable up to its current end, then replaces the
+  //       checkpoint atomically (temporary file, fsync, rename)
+  // Preconditions: m_output is open
+  // Postconditions: Returns false if the checkpoint could not be written
+bool BatchJob::SaveCheckpoint(){
+
+  // The checkpoint must never point past output that is not on disk yet
+
+  if((fflush(m_output) != 0) || (fsync(fileno(m_output)) != 0)){
+
+    return false;
+  }
+
+  string tempFile = m_checkpointFile + ".tmp";
+
+  FILE *checkpoint = fopen(tempFile.c_str(), "w");
+
+  if(checkpoint == nullptr){
+
+    return false;
+  }
+
+  fprintf(checkpoint, "sequencer-checkpoint %d\n", CHECKPOINT_VERSION);
+  fprintf(checkpoint, "input_size %llu\n", (unsigned long long)m_progress.m_inputSize);
+  fprintf(checkpoint, "input_offset %llu\n", (unsigned long long)m_progress.m_inputOffset);
+  fprintf(checkpoint, "records %llu\n", (unsigned long long)m_progress.m_records);
+  fprintf(checkpoint, "proteins %llu\n", (unsigned long long)m_progress.m_proteins);
+  fprintf(checkpoint, "skipped %llu\n", (unsigned long long)m_progress.m_skipped);
+  fprintf(checkpoint, "output_offset %llu\n", (unsigned long long)m_progress.m_outputOffset);
+  fprintf(checkpoint, "input %s\n", m_progress.m_input.c_str());
+
+  bool written = (fflush(checkpoint) == 0) && (fsync(fileno(checkpoint)) == 0);
+
+  written = (fclose(checkpoint) == 0) && written;
+
+  if(!written || (rename(tempFile.c_str(), m_checkpointFile.c_str()) != 0)){
+
+    remove(tempFile.c_str());
+
+    return false;
+  }
+
+  // Persist the rename itself
+
+  size_t slash = m_checkpointFile.rfind('/');
+
+  string directory = (slash == string::npos) ? "." : m_checkpointFile.substr(0, slash + 1);
+
+  int fd = open(directory.c_str(), O_RDONLY);
+
+  if(fd >= 0){
+
+    fsync(fd);
+
+    close(fd);
+  }
+
+  return true;
+
+}
@@ -0,0 +1,89 @@
+//Title: BatchJob.h
+//Author: Hazael Magino
+//Date: 10/19/2026
+//Description: Single-process streaming batch run with checkpoint and resume. Records
+//             are read, transcribed and translated one at a time and their proteins
+//             appended to a FASTA file. Progress (input offset, record counts and
+//             output offset) is checkpointed atomically every few seconds, and a
+//             restarted job continues from the last checkpoint instead of redoing
+//             completed records.
+
+#ifndef BATCHJOB_H
+#define BATCHJOB_H
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <cstdint>
+#include <cstdio>
+using namespace std;
+
+// Progress saved in a checkpoint; every count covers input before m_inputOffset
+struct BatchCheckpoint {
+  string m_input; //Input file the checkpoint belongs to
+  uint64_t m_inputSize; //Size of that file when the job started
+  uint64_t m_inputOffset; //Start of the first record not yet processed
+  uint64_t m_records; //Records read
+  uint64_t m_proteins; //Proteins written
+  uint64_t m_skipped; //Records skipped for invalid bases
+  uint64_t m_outputOffset; //Bytes of output that hold those proteins
+};
+
+class BatchJob {
+ public:
+  // Name: BatchJob (constructor)
+  // Desc: Prepares a batch run of fileName into outFile; the checkpoint is kept in
+  //       outFile + ".ckpt" and written at most every checkpointSeconds seconds
+  // Preconditions: None
+  // Postconditions: Nothing is read until Run
+  BatchJob(string fileName, string outFile, int checkpointSeconds, int threads,
+           const function<int(const string &)> &codeFor);
+  // Name: Run
+  // Desc: Resumes from the checkpoint if there is one (truncating the output to the
+  //       checkpointed offset), then processes every remaining record
+  // Preconditions: None
+  // Postconditions: Returns true once the whole input is done and the checkpoint
+  //                 is removed; otherwise false with error set
+  bool Run(string &error);
+  // Name: GetProgress
+  // Preconditions: None
+  // Postconditions: Returns the current progress counters
+  const BatchCheckpoint &GetProgress();
+  // Name: GetResumedFrom
+  // Preconditions: Run has been called
+  // Postconditions: Returns the records that were already done when Run started
+  uint64_t GetResumedFrom();
+  // Name: ConvertRecord (static)
+  // Desc: Parses one "name,bases" line (commas and carriage returns between bases
+  //       are skipped), transcribes it and translates the mRNA as FASTA
+  // Preconditions: line is one record without its line break
+  // Postconditions: Returns CORE_OK with fasta set, CORE_INVALID_BASE if the strand
+  //                 cannot be transcribed, or CORE_BAD_ARGUMENT if the line is not
+  //                 a record; name is set whenever the line is a record
+  static int ConvertRecord(const char *line, size_t length, const function<int(const string &)> &codeFor,
+                           vector<char> &scratch, string &name, string &fasta);
+ private:
+  // Name: LoadCheckpoint
+  // Desc: Reads the checkpoint file if it exists
+  // Preconditions: None
+  // Postconditions: Returns false with error set if a checkpoint exists but is
+  //                 damaged or belongs to another input; m_progress is set
+  bool LoadCheckpoint(string &error);
+  // Name: SaveCheckpoint
+  // Desc: Makes the output durable up to its current end, then replaces the
+  //       checkpoint atomically (temporary file, fsync, rename)
+  // Preconditions: m_output is open
+  // Postconditions: Returns false if the checkpoint could not be written
+  bool SaveCheckpoint();
+  string m_fileName; //Input file
+  string m_outFile; //FASTA output
+  string m_checkpointFile; //Checkpoint next to the output
+  int m_checkpointSeconds; //Minimum time between checkpoints
+  int m_threads; //Decompression threads
+  function<int(const string &)> m_codeFor; //Genetic code of a strand
+  BatchCheckpoint m_progress; //Progress so far
+  uint64_t m_resumedFrom; //Records already done when Run started
+  FILE *m_output; //Output while Run is active
+};
+
+#endif
@@ -0,0 +1,439 @@
+// File:    CodonProfile.cpp
+// Author:  Hazael Magino
+// Date:    10/19/2026
+// Section: Section 12
+// E-mail:  hazaelm1@umbc.edu
+// Description: Codon usage profiling across every strand in a sequencer. Codons are
+// counted straight from the strand buffers, strands are split across threads, and
+// the per-thread corpus tables are merged once at the end.
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include "CodonProfile.h"
+#include "SequencerCore.h"
+#include "TranslateKernel.h"
+
+using namespace std;
+
+const char CODON_BASES[] = "UCAG"; //Base order used for codon indexes
+const double PSEUDOCOUNT = 0.5; //Keeps unused codons from zeroing out CAI
+
+const size_t INDEX_BLOCK = 4096; //Codons turned into indexes at a time
+const unsigned char INVALID_INDEX = 'X'; //What TranslateCodons writes for invalid codons
+
+// "Translation tables" whose residues are codon indexes, so TranslateCodons turns
+// codons into indexes. A DNA base's digit plus 2 (mod 4) is the digit of the mRNA base
+// it transcribes to (A->U, G->C, T->A, C->G), which flips bit 1 of every digit.
+struct CodonIndexes {
+  char m_mRNA[CODON_BINS];
+  char m_DNA[CODON_BINS];
+  CodonIndexes(){
+    for(int c = 0; c < CODON_BINS; c++){
+      m_mRNA[c] = c;
+      m_DNA[c] = c ^ 0x2A;
+    }
+  }
+};
+
+const CodonIndexes CODON_INDEXES;
+
+  // Name: CodonProfile (constructor)
+  // Desc: Creates an empty profile
+  // Preconditions: None
+  // Postconditions: All counts are zero
+CodonProfile::CodonProfile(){
+
+  memset(m_total, 0, sizeof(m_total));
+
+  m_bases = 0;
+
+}
+
+  // Name: Profile
+  // Desc: Counts the codons of every strand. Strands are shared out across
+  //       threads; each thread keeps its own corpus table and the tables are
+  //       merged at the end. DNA strands are counted as the codons of the
+  //       mRNA they transcribe to. codeFor gives each strand's genetic code,
+  //       which decides the synonym families used by RSCU and CAI.
+  // Preconditions: strands are not modified while profiling
+  // Postconditions: One row per strand and the corpus totals are stored; strands
+  //                 whose bases could not be loaded are left out (see GetSkipped)
+void CodonProfile::Profile(vector<Strand*> &strands, bool isDNA, int threads,
+                           const function<int(const string &)> &codeFor){
+
+  if(threads < 1){
+
+    threads = 1;
+  }
+
+  m_rows.assign(strands.size(), CodonCounts());
+
+  vector<vector<long long> > partials(threads, vector<long long>(CODON_BINS + 1, 0));
+
+  vector<long long> partialBases(threads, 0);
+
+  atomic<unsigned int> next(0);
+
+  // Each worker claims the next unprofiled strand until none are left
+
+  auto worker = [&](int id){
+
+    for(unsigned int i = next++; i < strands.size(); i = next++){
+
+      CodonCounts &row = m_rows.at(i);
+
+      row.m_name = strands.at(i)->GetName();
+
+      memset(row.m_bins, 0, sizeof(row.m_bins));
+
+      // Pinning keeps the buffer valid while other workers unpin (and evict)
+
+      row.m_skipped = !strands.at(i)->Pin();
+
+      if(row.m_skipped){
+
+        continue;
+      }
+
+      CountCodons(strands.at(i)->GetBuffer(), strands.at(i)->GetSize(), isDNA, row.m_bins);
+
+      strands.at(i)->Unpin();
+
+      for(int b = 0; b <= CODON_BINS; b++){
+
+        partials.at(id).at(b) += row.m_bins[b];
+      }
+
+      partialBases.at(id) += strands.at(i)->GetSize();
+    }
+  };
+
+  vector<thread> pool;
+
+  for(int t = 1; t < threads; t++){
+
+    pool.push_back(thread(worker, t));
+  }
+
+  worker(0);
+
+  for(unsigned int t = 0; t < pool.size(); t++){
+
+    pool.at(t).join();
+  }
+
+  // Merge the per-thread tables
+
+  for(int t = 0; t < threads; t++){
+
+    for(int b = 0; b <= CODON_BINS; b++){
+
+      m_total[b] += partials.at(t).at(b);
+    }
+
+    m_bases += partialBases.at(t);
+  }
+
+  // Strands that could not be loaded get no row
+
+  unsigned int kept = 0;
+
+  for(unsigned int r = 0; r < m_rows.size(); r++){
+
+    if(m_rows.at(r).m_skipped){
+
+      m_skipped.push_back(m_rows.at(r).m_name);
+
+    }else{
+
+      m_rows.at(kept++) = m_rows.at(r);
+    }
+  }
+
+  m_rows.resize(kept);
+
+  // Group the rows by genetic code; each code has its own synonym families
+
+  for(unsigned int r = 0; r < m_rows.size(); r++){
+
+    CodonCounts &row = m_rows.at(r);
+
+    row.m_code = codeFor(row.m_name);
+
+    map<int, CodeUsage>::iterator found = m_codes.find(row.m_code);
+
+    if(found == m_codes.end()){
+
+      CodeUsage usage;
+
+      memset(usage.m_bins, 0, sizeof(usage.m_bins));
+
+      for(int c = 0; c < CODON_BINS; c++){
+
+        char name[3] = {CODON_BASES[c >> 4], CODON_BASES[(c >> 2) & 3], CODON_BASES[c & 3]};
+
+        usage.m_residues[c] = CoreCodonToResidue(name, row.m_code);
+      }
+
+      found = m_codes.insert(make_pair(row.m_code, usage)).first;
+    }
+
+    for(int b = 0; b <= CODON_BINS; b++){
+
+      found->second.m_bins[b] += row.m_bins[b];
+    }
+  }
+
+  for(map<int, CodeUsage>::iterator curr = m_codes.begin(); curr != m_codes.end(); curr++){
+
+    BuildWeights(curr->second);
+  }
+
+}
+
+  // Name: CountCodons (static)
+  // Desc: Adds the codons of size bases to bins (incomplete trailing codons are ignored).
+  //       TranslateCodons turns each block of codons into codon indexes with the
+  //       selected SIMD kernel, then the indexes are counted into four interleaved
+  //       tables so consecutive increments of one codon do not wait on each other.
+  // Preconditions: bins has CODON_BINS + 1 entries
+  // Postconditions: bins is updated
+void CodonProfile::CountCodons(const char *bases, int size, bool isDNA, long long *bins){
+
+  const char *indexes = isDNA ? CODON_INDEXES.m_DNA : CODON_INDEXES.m_mRNA;
+
+  unsigned char block[INDEX_BLOCK];
+
+  unsigned int counts[4][256]; // indexes up to INVALID_INDEX, one table per lane
+
+  memset(counts, 0, sizeof(counts));
+
+  size_t codons = size / 3;
+
+  for(size_t done = 0; done < codons; done += INDEX_BLOCK){
+
+    size_t count = min(INDEX_BLOCK, codons - done);
+
+    TranslateCodons(bases + done * 3, count, indexes, (char *)block);
+
+    size_t k = 0;
+
+    for(; k + 4 <= count; k += 4){
+
+      counts[0][block[k]]++;
+      counts[1][block[k + 1]]++;
+      counts[2][block[k + 2]]++;
+      counts[3][block[k + 3]]++;
+    }
+
+    for(; k < count; k++){
+
+      counts[0][block[k]]++;
+    }
+  }
+
+  for(int lane = 0; lane < 4; lane++){
+
+    for(int c = 0; c < CODON_BINS; c++){
+
+      bins[c] += counts[lane][c];
+    }
+
+    bins[INVALID_BIN] += counts[lane][INVALID_INDEX];
+  }
+
+}
+
+  // Name: GetRSCU
+  // Desc: Relative synonymous codon usage of a codon across the strands using code
+  // Preconditions: Profile has been called
+  // Postconditions: Returns observed / expected count if synonyms were used evenly
+double CodonProfile::GetRSCU(int codon, int code){
+
+  map<int, CodeUsage>::iterator found = m_codes.find(code);
+
+  if(found == m_codes.end()){
+
+    return 0.0;
+  }
+
+  const CodeUsage &usage = found->second;
+
+  long long family = 0;
+
+  int synonyms = 0;
+
+  for(int c = 0; c < CODON_BINS; c++){
+
+    if(usage.m_residues[c] == usage.m_residues[codon]){
+
+      family += usage.m_bins[c];
+
+      synonyms++;
+    }
+  }
+
+  if(family == 0){
+
+    return 0.0;
+  }
+
+  return double(usage.m_bins[codon]) * synonyms / family;
+
+}
+
+  // Name: GetCAI
+  // Desc: Codon adaptation index of a row against the codon weights of the strands
+  //       that share its genetic code
+  // Preconditions: Profile has been called
+  // Postconditions: Returns the geometric mean of the weights of the row's codons
+double CodonProfile::GetCAI(int row){
+
+  const double *weights = m_codes.at(m_rows.at(row).m_code).m_weights;
+
+  double logSum = 0.0;
+
+  long long used = 0;
+
+  for(int c = 0; c < CODON_BINS; c++){
+
+    // Codons with no synonyms (and stops) carry no weight
+
+    if(weights[c] <= 0.0){
+
+      continue;
+    }
+
+    logSum += m_rows.at(row).m_bins[c] * log(weights[c]);
+
+    used += m_rows.at(row).m_bins[c];
+  }
+
+  if(used == 0){
+
+    return 0.0;
+  }
+
+  return exp(logSum / used);
+
+}
+
+  // Name: GetSkipped
+  // Preconditions: Profile has been called
+  // Postconditions: Returns the names of the strands left out because their bases
+  //                 could not be loaded, in strand order
+const vector<string> &CodonProfile::GetSkipped(){
+
+  return m_skipped;
+
+}
+
+  // Name: GetBaseCount
+  // Preconditions: Profile has been called
+  // Postconditions: Returns the number of bases that were profiled
+long long CodonProfile::GetBaseCount(){
+
+  return m_bases;
+
+}
+
+  // Name: WriteMatrix
+  // Desc: Writes a tab separated matrix with one row per strand (64 codon
+  //       counts then CAI) followed by the corpus row and an RSCU row per
+  //       genetic code (labelled with the code when there is more than one)
+  // Preconditions: output is open
+  // Postconditions: Matrix is written to output
+void CodonProfile::WriteMatrix(ostream &output){
+
+  output << "name";
+
+  for(int c = 0; c < CODON_BINS; c++){
+
+    output << '\t' << CODON_BASES[c >> 4] << CODON_BASES[(c >> 2) & 3] << CODON_BASES[c & 3];
+  }
+
+  output << "\tinvalid\tCAI\n";
+
+  for(unsigned int r = 0; r < m_rows.size(); r++){
+
+    output << m_rows.at(r).m_name;
+
+    for(int b = 0; b <= CODON_BINS; b++){
+
+      output << '\t' << m_rows.at(r).m_bins[b];
+    }
+
+    output << '\t' << GetCAI(r) << '\n';
+  }
+
+  output << "corpus";
+
+  for(int b = 0; b <= CODON_BINS; b++){
+
+    output << '\t' << m_total[b];
+  }
+
+  output << "\t\n";
+
+  for(map<int, CodeUsage>::iterator curr = m_codes.begin(); curr != m_codes.end(); curr++){
+
+    output << "RSCU";
+
+    if(m_codes.size() > 1){
+
+      output << " code " << curr->first;
+    }
+
+    for(int c = 0; c < CODON_BINS; c++){
+
+      output << '\t' << GetRSCU(c, curr->first);
+    }
+
+    output << "\t\t\n";
+  }
+
+}
+
+  // Name: BuildWeights
+  // Desc: Computes the relative adaptiveness of each codon within its amino acid
+  //       under the code
+  // Preconditions: usage.m_bins and usage.m_residues are populated
+  // Postconditions: usage.m_weights is populated
+void CodonProfile::BuildWeights(CodeUsage &usage){
+
+  const char *residues = usage.m_residues;
+
+  for(int c = 0; c < CODON_BINS; c++){
+
+    double best = 0.0;
+
+    int synonyms = 0;
+
+    for(int o = 0; o < CODON_BINS; o++){
+
+      if(residues[o] == residues[c]){
+
+        best = max(best, usage.m_bins[o] + PSEUDOCOUNT);
+
+        synonyms++;
+      }
+    }
+
+    // Stops and single codon amino acids (Met, Trp) are left out of CAI
+
+    if((residues[c] == '*') || (synonyms == 1)){
+
+      usage.m_weights[c] = 0.0;
+
+    }else{
+
+      usage.m_weights[c] = (usage.m_bins[c] + PSEUDOCOUNT) / best;
+    }
+  }
+
+}
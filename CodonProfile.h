@@ -0,0 +1,105 @@
+//Title: CodonProfile.h
+//Author: Hazael Magino
+//Date: 10/19/2026
+//Description: Codon usage profiling. Counts the 64 codons of every strand (codon
+//             indexes come from the SIMD translation kernels, no codon strings), in
+//             parallel across strands, and derives RSCU and CAI from the counts
+//             under each strand's genetic code.
+
+#ifndef CODONPROFILE_H
+#define CODONPROFILE_H
+
+#include "Strand.h"
+
+#include <string>
+#include <vector>
+#include <map>
+#include <functional>
+#include <iostream>
+using namespace std;
+
+const int CODON_BINS = 64; //Number of distinct codons
+const int INVALID_BIN = 64; //Bin for codons holding anything other than A, C, G, T or U
+
+struct CodonCounts {
+  string m_name; //Name of the profiled strand
+  int m_code; //Genetic code the strand is translated with
+  long long m_bins[CODON_BINS + 1]; //Counts per codon (NCBI UCAG order) plus invalid
+  bool m_skipped; //The strand's bases could not be loaded; left out of the profile
+};
+
+// Totals and CAI weights of the strands that share one genetic code
+struct CodeUsage {
+  long long m_bins[CODON_BINS + 1]; //Counts of the strands using the code
+  char m_residues[CODON_BINS]; //Residue of each codon under the code
+  double m_weights[CODON_BINS]; //Relative adaptiveness used by CAI
+};
+
+class CodonProfile {
+ public:
+  // Name: CodonProfile (constructor)
+  // Desc: Creates an empty profile
+  // Preconditions: None
+  // Postconditions: All counts are zero
+  CodonProfile();
+  // Name: Profile
+  // Desc: Counts the codons of every strand. Strands are shared out across
+  //       threads; each thread keeps its own corpus table and the tables are
+  //       merged at the end. DNA strands are counted as the codons of the
+  //       mRNA they transcribe to. codeFor gives each strand's genetic code,
+  //       which decides the synonym families used by RSCU and CAI.
+  // Preconditions: strands are not modified while profiling
+  // Postconditions: One row per strand and the corpus totals are stored; strands
+  //                 whose bases could not be loaded are left out (see GetSkipped)
+  void Profile(vector<Strand*> &strands, bool isDNA, int threads,
+               const function<int(const string &)> &codeFor);
+  // Name: CountCodons (static)
+  // Desc: Adds the codons of size bases to bins (incomplete trailing codons are ignored).
+  //       TranslateCodons turns each block of codons into codon indexes with the
+  //       selected SIMD kernel, then the indexes are counted into four interleaved
+  //       tables so consecutive increments of one codon do not wait on each other.
+  // Preconditions: bins has CODON_BINS + 1 entries
+  // Postconditions: bins is updated
+  static void CountCodons(const char *bases, int size, bool isDNA, long long *bins);
+  // Name: GetRSCU
+  // Desc: Relative synonymous codon usage of a codon across the strands using code
+  // Preconditions: Profile has been called
+  // Postconditions: Returns observed / expected count if synonyms were used evenly
+  double GetRSCU(int codon, int code);
+  // Name: GetCAI
+  // Desc: Codon adaptation index of a row against the codon weights of the strands
+  //       that share its genetic code
+  // Preconditions: Profile has been called
+  // Postconditions: Returns the geometric mean of the weights of the row's codons
+  double GetCAI(int row);
+  // Name: GetSkipped
+  // Preconditions: Profile has been called
+  // Postconditions: Returns the names of the strands left out because their bases
+  //                 could not be loaded, in strand order
+  const vector<string> &GetSkipped();
+  // Name: GetBaseCount
+  // Preconditions: Profile has been called
+  // Postconditions: Returns the number of bases that were profiled
+  long long GetBaseCount();
+  // Name: WriteMatrix
+  // Desc: Writes a tab separated matrix with one row per strand (64 codon
+  //       counts then CAI) followed by the corpus row and an RSCU row per
+  //       genetic code (labelled with the code when there is more than one)
+  // Preconditions: output is open
+  // Postconditions: Matrix is written to output
+  void WriteMatrix(ostream &output);
+ private:
+  // Name: BuildWeights
+  // Desc: Computes the relative adaptiveness of each codon within its amino acid
+  //       under the code
+  // Preconditions: usage.m_bins and usage.m_residues are populated
+  // Postconditions: usage.m_weights is populated
+  void BuildWeights(CodeUsage &usage);
+  vector<CodonCounts> m_rows; //One row per profiled strand
+  long long m_total[CODON_BINS + 1]; //Corpus counts
+  map<int, CodeUsage> m_codes; //Totals and weights per genetic code in use
+  long long m_bases; //Bases profiled
+  vector<string> m_skipped; //Strands whose bases could not be loaded
+};
+
+#endif
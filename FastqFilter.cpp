@@ -0,0 +1,358 @@
+// File:    FastqFilter.cpp
+// Author:  Hazael Magino
+// Date:    10/19/2026
+// Section: Section 12
+// E-mail:  hazaelm1@umbc.edu
+// Description: FASTQ trimming and filtering. The window scan sums the qualities of 16
+// window starts at once in 16 bit lanes, so a read of length n costs about
+// n * window / 16 additions; adapter search compares the adapter's first and last
+// base at 16 positions at once and only verifies the candidates. Everything works on
+// the raw record text, so a dropped read never allocates anything. Without SSE2 the
+// same scans run one position at a time.
+
+#include <string>
+#include <vector>
+#include <cstring>
+#include "FastqFilter.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+using namespace std;
+
+  // Name: FastqFilter (constructor)
+  // Preconditions: 1 <= settings.m_window <= 128
+  // Postconditions: Creates a filter with empty statistics
+FastqFilter::FastqFilter(const FastqSettings &settings){
+
+  m_settings = settings;
+
+}
+
+  // Name: Process
+  // Desc: Trims and filters one read
+  // Preconditions: bases and quality hold length chars each
+  // Postconditions: Returns how many leading bases to keep, or -1 if the read
+  //                 is dropped; the statistics are updated
+int FastqFilter::Process(const char *bases, const char *quality, size_t length){
+
+  m_stats.m_reads++;
+
+  size_t keep = QualityTrim(quality, length, m_settings.m_window, m_settings.m_minQuality);
+
+  if(!m_settings.m_adapter.empty()){
+
+    keep = FindAdapter(bases, keep, m_settings.m_adapter, m_settings.m_minOverlap);
+  }
+
+  if(keep < size_t(m_settings.m_minLength) || (keep == 0)){
+
+    m_stats.m_short++;
+
+    return -1;
+  }
+
+  if(IsLowComplexity(bases, keep, m_settings.m_maxBaseFraction)){
+
+    m_stats.m_lowComplexity++;
+
+    return -1;
+  }
+
+  m_stats.m_kept++;
+
+  if(keep < length){
+
+    m_stats.m_trimmed++;
+
+    m_stats.m_trimmedBases += length - keep;
+  }
+
+  return keep;
+
+}
+
+  // Name: CountMalformed
+  // Preconditions: None
+  // Postconditions: One more record is counted as malformed
+void FastqFilter::CountMalformed(){
+
+  m_stats.m_malformed++;
+
+}
+
+  // Name: GetStats
+  // Preconditions: None
+  // Postconditions: Returns the statistics so far
+const FastqStats &FastqFilter::GetStats(){
+
+  return m_stats;
+
+}
+
+  // Name: QualityTrim (static)
+  // Desc: Finds the first window of window bases whose mean Phred score is below
+  //       minQuality (a read shorter than window is one window)
+  // Preconditions: window >= 1
+  // Postconditions: Returns the start of that window, or length if every window passes
+size_t FastqFilter::QualityTrim(const char *quality, size_t length, int window, int minQuality){
+
+  if(length == 0){
+
+    return 0;
+  }
+
+  size_t span = min(size_t(window), length);
+
+  // Compare raw sums against the threshold so the offset is never subtracted
+
+  int threshold = span * (minQuality + PHRED_OFFSET);
+
+  size_t start = 0;
+
+#ifdef __SSE2__
+  // 16 window starts per step: lane j sums quality[start + j .. start + j + span)
+
+  const __m128i zero = _mm_setzero_si128();
+
+  const __m128i limit = _mm_set1_epi16(threshold);
+
+  for(; start + 16 + span - 1 <= length; start += 16){
+
+    __m128i low = zero;
+
+    __m128i high = zero;
+
+    for(size_t k = 0; k < span; k++){
+
+      __m128i chunk = _mm_loadu_si128((const __m128i *)(quality + start + k));
+
+      low = _mm_add_epi16(low, _mm_unpacklo_epi8(chunk, zero));
+
+      high = _mm_add_epi16(high, _mm_unpackhi_epi8(chunk, zero));
+    }
+
+    __m128i failed = _mm_packs_epi16(_mm_cmplt_epi16(low, limit), _mm_cmplt_epi16(high, limit));
+
+    int mask = _mm_movemask_epi8(failed);
+
+    if(mask != 0){
+
+      return start + __builtin_ctz(mask);
+    }
+  }
+#endif
+
+  // The remaining window starts (all of them without SSE2) keep a running sum
+
+  if(start + span > length){
+
+    return length;
+  }
+
+  int sum = 0;
+
+  for(size_t k = 0; k < span; k++){
+
+    sum += (unsigned char)quality[start + k];
+  }
+
+  while(true){
+
+    if(sum < threshold){
+
+      return start;
+    }
+
+    if(start + span >= length){
+
+      return length;
+    }
+
+    sum += (unsigned char)quality[start + span] - (unsigned char)quality[start];
+
+    start++;
+  }
+
+}
+
+  // Name: FindAdapter (static)
+  // Desc: Finds the first full copy of adapter, or else the longest adapter prefix
+  //       of at least minOverlap bases that ends the read
+  // Preconditions: None
+  // Postconditions: Returns where the adapter starts, or length if there is none
+size_t FastqFilter::FindAdapter(const char *bases, size_t length, const string &adapter, int minOverlap){
+
+  size_t size = adapter.length();
+
+  if(size == 0){
+
+    return length;
+  }
+
+  size_t pos = 0;
+
+  if(length >= size){
+
+#ifdef __SSE2__
+    // Candidates match the adapter's first and last base; 16 positions per step
+
+    const __m128i first = _mm_set1_epi8(adapter[0]);
+
+    const __m128i last = _mm_set1_epi8(adapter[size - 1]);
+
+    for(; pos + 16 + size - 1 <= length; pos += 16){
+
+      __m128i head = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(bases + pos)), first);
+
+      __m128i tail = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(bases + pos + size - 1)), last);
+
+      int mask = _mm_movemask_epi8(_mm_and_si128(head, tail));
+
+      while(mask != 0){
+
+        size_t candidate = pos + __builtin_ctz(mask);
+
+        if(memcmp(bases + candidate, adapter.data(), size) == 0){
+
+          return candidate;
+        }
+
+        mask &= mask - 1;
+      }
+    }
+#endif
+
+    for(; pos + size <= length; pos++){
+
+      if(memcmp(bases + pos, adapter.data(), size) == 0){
+
+        return pos;
+      }
+    }
+  }
+
+  // Only part of the adapter fits before the end of the read
+
+  size_t longest = min(size - 1, length);
+
+  for(size_t overlap = longest; (overlap >= size_t(max(minOverlap, 1))) && (overlap > 0); overlap--){
+
+    if(memcmp(bases + length - overlap, adapter.data(), overlap) == 0){
+
+      return length - overlap;
+    }
+  }
+
+  return length;
+
+}
+
+  // Name: IsLowComplexity (static)
+  // Desc: Checks whether a single base makes up more than maxFraction of the read
+  // Preconditions: None
+  // Postconditions: Returns true for low complexity reads (poly-A, poly-G, ...)
+bool FastqFilter::IsLowComplexity(const char *bases, size_t length, double maxFraction){
+
+  const char ALPHABET[4] = {'A', 'C', 'G', 'T'};
+
+  size_t counts[4] = {0, 0, 0, 0};
+
+  size_t i = 0;
+
+#ifdef __SSE2__
+  __m128i letters[4];
+
+  for(int b = 0; b < 4; b++){
+
+    letters[b] = _mm_set1_epi8(ALPHABET[b]);
+  }
+
+  for(; i + 16 <= length; i += 16){
+
+    __m128i chunk = _mm_loadu_si128((const __m128i *)(bases + i));
+
+    for(int b = 0; b < 4; b++){
+
+      counts[b] += __builtin_popcount(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, letters[b])));
+    }
+  }
+#endif
+
+  for(; i < length; i++){
+
+    for(int b = 0; b < 4; b++){
+
+      counts[b] += (bases[i] == ALPHABET[b]);
+    }
+  }
+
+  size_t most = max(max(counts[0], counts[1]), max(counts[2], counts[3]));
+
+  return most > maxFraction * length;
+
+}
+
+// Bin of one quality char (0-3)
+static uint8_t QualityBin(char quality){
+
+  int score = (unsigned char)quality - PHRED_OFFSET;
+
+  return (score >= 10) + (score >= 20) + (score >= 30);
+
+}
+
+  // Name: PackQualities (static)
+  // Desc: Bins each quality to 0-3 (below Q10, Q10-19, Q20-29, Q30 and up) and
+  //       packs 4 bins per byte, first base in the low bits
+  // Preconditions: quality holds length chars
+  // Postconditions: packed holds (length + 3) / 4 bytes
+void FastqFilter::PackQualities(const char *quality, size_t length, vector<uint8_t> &packed){
+
+  packed.assign((length + 3) / 4, 0);
+
+  size_t i = 0;
+
+#ifdef __SSE2__
+  const __m128i q10 = _mm_set1_epi8(PHRED_OFFSET + 9);
+
+  const __m128i q20 = _mm_set1_epi8(PHRED_OFFSET + 19);
+
+  const __m128i q30 = _mm_set1_epi8(PHRED_OFFSET + 29);
+
+  const __m128i lowByte = _mm_set1_epi32(0xFF);
+
+  for(; i + 16 <= length; i += 16){
+
+    __m128i chunk = _mm_loadu_si128((const __m128i *)(quality + i));
+
+    // Each comparison is 0 or -1, so subtracting them counts the thresholds passed
+
+    __m128i bins = _mm_sub_epi8(_mm_setzero_si128(), _mm_cmpgt_epi8(chunk, q10));
+
+    bins = _mm_sub_epi8(bins, _mm_cmpgt_epi8(chunk, q20));
+
+    bins = _mm_sub_epi8(bins, _mm_cmpgt_epi8(chunk, q30));
+
+    // Fold the 4 bins of each 32 bit lane into its low byte: b0 | b1 << 2 | b2 << 4 | b3 << 6
+
+    __m128i folded = _mm_or_si128(_mm_or_si128(bins, _mm_srli_epi32(bins, 6)),
+                                  _mm_or_si128(_mm_srli_epi32(bins, 12), _mm_srli_epi32(bins, 18)));
+
+    folded = _mm_and_si128(folded, lowByte);
+
+    folded = _mm_packus_epi16(_mm_packs_epi32(folded, folded), folded);
+
+    int bytes = _mm_cvtsi128_si32(folded);
+
+    memcpy(&packed[i / 4], &bytes, 4);
+  }
+#endif
+
+  for(; i < length; i++){
+
+    packed[i / 4] |= QualityBin(quality[i]) << (2 * (i % 4));
+  }
+
+}
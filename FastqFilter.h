@@ -0,0 +1,89 @@
+//Title: FastqFilter.h
+//Author: Hazael Magino
+//Date: 10/19/2026
+//Description: Quality trimming and filtering of FASTQ reads before they become
+//             strands. Each read is cut at the first sliding window whose mean
+//             quality is too low and at the Illumina adapter (full or a partial
+//             match at the 3' end), then dropped if it is too short or low
+//             complexity. The scans over qualities and bases use SSE2. Kept
+//             qualities are binned to 2 bits per base (4 levels).
+
+#ifndef FASTQFILTER_H
+#define FASTQFILTER_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+using namespace std;
+
+const int PHRED_OFFSET = 33; //Sanger / Illumina 1.8+ quality encoding
+const int QUALITY_BINS[4] = {6, 15, 25, 37}; //Phred score each 2 bit bin stands for
+
+struct FastqSettings {
+  int m_window = 4; //Bases in the sliding quality window
+  int m_minQuality = 20; //Lowest mean Phred score a window may have
+  int m_minLength = 30; //Shorter reads are dropped after trimming
+  string m_adapter = "AGATCGGAAGAGC"; //Adapter cut from the reads ("" for none)
+  int m_minOverlap = 5; //Shortest adapter prefix matched at the 3' end
+  double m_maxBaseFraction = 0.8; //A read with one base above this fraction is low complexity
+};
+
+struct FastqStats {
+  long long m_reads = 0; //Records read
+  long long m_kept = 0; //Reads that became strands
+  long long m_trimmed = 0; //Kept reads that lost bases
+  long long m_trimmedBases = 0; //Bases cut from kept reads
+  long long m_short = 0; //Reads dropped for length
+  long long m_lowComplexity = 0; //Reads dropped for low complexity
+  long long m_malformed = 0; //Records that were not valid FASTQ
+};
+
+class FastqFilter {
+ public:
+  // Name: FastqFilter (constructor)
+  // Preconditions: 1 <= settings.m_window <= 128
+  // Postconditions: Creates a filter with empty statistics
+  FastqFilter(const FastqSettings &settings = FastqSettings());
+  // Name: Process
+  // Desc: Trims and filters one read
+  // Preconditions: bases and quality hold length chars each
+  // Postconditions: Returns how many leading bases to keep, or -1 if the read
+  //                 is dropped; the statistics are updated
+  int Process(const char *bases, const char *quality, size_t length);
+  // Name: CountMalformed
+  // Preconditions: None
+  // Postconditions: One more record is counted as malformed
+  void CountMalformed();
+  // Name: GetStats
+  // Preconditions: None
+  // Postconditions: Returns the statistics so far
+  const FastqStats &GetStats();
+  // Name: QualityTrim (static)
+  // Desc: Finds the first window of window bases whose mean Phred score is below
+  //       minQuality (a read shorter than window is one window)
+  // Preconditions: window >= 1
+  // Postconditions: Returns the start of that window, or length if every window passes
+  static size_t QualityTrim(const char *quality, size_t length, int window, int minQuality);
+  // Name: FindAdapter (static)
+  // Desc: Finds the first full copy of adapter, or else the longest adapter prefix
+  //       of at least minOverlap bases that ends the read
+  // Preconditions: None
+  // Postconditions: Returns where the adapter starts, or length if there is none
+  static size_t FindAdapter(const char *bases, size_t length, const string &adapter, int minOverlap);
+  // Name: IsLowComplexity (static)
+  // Desc: Checks whether a single base makes up more than maxFraction of the read
+  // Preconditions: None
+  // Postconditions: Returns true for low complexity reads (poly-A, poly-G, ...)
+  static bool IsLowComplexity(const char *bases, size_t length, double maxFraction);
+  // Name: PackQualities (static)
+  // Desc: Bins each quality to 0-3 (below Q10, Q10-19, Q20-29, Q30 and up) and
+  //       packs 4 bins per byte, first base in the low bits
+  // Preconditions: quality holds length chars
+  // Postconditions: packed holds (length + 3) / 4 bytes
+  static void PackQualities(const char *quality, size_t length, vector<uint8_t> &packed);
+ private:
+  FastqSettings m_settings; //Trimming and filtering settings
+  FastqStats m_stats; //Counts of what happened to the reads
+};
+
+#endif
@@ -0,0 +1,149 @@
+//Title: GeneticCode.h
+//Author: Hazael Magino
+//Date: 10/19/2026
+//Description: NCBI genetic codes (translation tables) generated at compile time. Each
+//             code is written as the few codons where it differs from the standard
+//             code; GeneticCode<ID>::TABLE expands that into the full 64-entry table
+//             (NCBI order: first, second then third base each in U, C, A, G) as a
+//             constexpr, so a translation kernel instantiated for one code has its
+//             table baked in and never branches on which code is in use.
+
+#ifndef GENETICCODE_H
+#define GENETICCODE_H
+
+#include <array>
+#include <cstddef>
+using namespace std;
+
+const int DEFAULT_GENETIC_CODE = 1; //NCBI table 1, the standard code
+
+// IDs of every NCBI genetic code (7, 8, 17-20 and 32 are unassigned)
+constexpr int GENETIC_CODE_IDS[] = {1, 2, 3, 4, 5, 6, 9, 10, 11, 12, 13, 14, 15, 16,
+                                    21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 33};
+
+constexpr char STANDARD_CODE_TABLE[] = "FFLLSSSSYY**CC*WLLLLPPPPHHQQRRRRIIIMTTTTNNKKSSRRVVVVAAAADDEEGGGG";
+
+// One codon whose residue differs from the standard code.
+// A null codon ends the list (and lets codes with no changes have a list).
+struct CodonOverride {
+  const char *m_codon;
+  char m_residue;
+};
+
+  // Name: CodonDigit
+  // Desc: 2 bit digit of one base in NCBI order (T is read as U)
+  // Preconditions: base is U, T, C, A or G
+  // Postconditions: Returns 0 to 3
+constexpr int CodonDigit(char base){
+
+  return (base == 'U' || base == 'T') ? 0 : (base == 'C') ? 1 : (base == 'A') ? 2 : 3;
+
+}
+
+  // Name: BuildCodeTable
+  // Desc: Expands the standard code plus a list of overrides into a full table
+  // Preconditions: overrides ends with a null codon
+  // Postconditions: Returns the 64-entry table
+template<size_t N>
+constexpr array<char, 64> BuildCodeTable(const CodonOverride (&overrides)[N]){
+
+  array<char, 64> table = {};
+
+  for(int c = 0; c < 64; c++){
+
+    table[c] = STANDARD_CODE_TABLE[c];
+  }
+
+  for(size_t o = 0; (o < N) && (overrides[o].m_codon != nullptr); o++){
+
+    const char *codon = overrides[o].m_codon;
+
+    table[CodonDigit(codon[0]) * 16 + CodonDigit(codon[1]) * 4 + CodonDigit(codon[2])] = overrides[o].m_residue;
+  }
+
+  return table;
+
+}
+
+  // Name: TableMatches
+  // Desc: Compile-time check of a generated table against NCBI's published string
+  // Preconditions: expected has 64 residues
+  // Postconditions: Returns true if every entry matches
+constexpr bool TableMatches(const array<char, 64> &table, const char *expected){
+
+  for(int c = 0; c < 64; c++){
+
+    if(table[c] != expected[c]){
+
+      return false;
+    }
+  }
+
+  return true;
+
+}
+
+// Compact spec of each code: its name and where it differs from the standard code
+template<int ID> struct GeneticCodeSpec;
+
+#define GENETIC_CODE_SPEC(ID, LABEL, ...) \
+  template<> struct GeneticCodeSpec<ID> { \
+    static constexpr const char *NAME = LABEL; \
+    static constexpr CodonOverride OVERRIDES[] = {__VA_ARGS__, {nullptr, 0}}; \
+  }
+
+GENETIC_CODE_SPEC(1, "Standard", {nullptr, 0});
+GENETIC_CODE_SPEC(2, "Vertebrate Mitochondrial", {"AGA", '*'}, {"AGG", '*'}, {"AUA", 'M'}, {"UGA", 'W'});
+GENETIC_CODE_SPEC(3, "Yeast Mitochondrial", {"AUA", 'M'}, {"CUU", 'T'}, {"CUC", 'T'}, {"CUA", 'T'},
+                  {"CUG", 'T'}, {"UGA", 'W'});
+GENETIC_CODE_SPEC(4, "Mold, Protozoan, and Coelenterate Mitochondrial and Mycoplasma/Spiroplasma",
+                  {"UGA", 'W'});
+GENETIC_CODE_SPEC(5, "Invertebrate Mitochondrial", {"AGA", 'S'}, {"AGG", 'S'}, {"AUA", 'M'}, {"UGA", 'W'});
+GENETIC_CODE_SPEC(6, "Ciliate, Dasycladacean and Hexamita Nuclear", {"UAA", 'Q'}, {"UAG", 'Q'});
+GENETIC_CODE_SPEC(9, "Echinoderm and Flatworm Mitochondrial", {"AAA", 'N'}, {"AGA", 'S'}, {"AGG", 'S'},
+                  {"UGA", 'W'});
+GENETIC_CODE_SPEC(10, "Euplotid Nuclear", {"UGA", 'C'});
+GENETIC_CODE_SPEC(11, "Bacterial, Archaeal and Plant Plastid", {nullptr, 0});
+GENETIC_CODE_SPEC(12, "Alternative Yeast Nuclear", {"CUG", 'S'});
+GENETIC_CODE_SPEC(13, "Ascidian Mitochondrial", {"AGA", 'G'}, {"AGG", 'G'}, {"AUA", 'M'}, {"UGA", 'W'});
+GENETIC_CODE_SPEC(14, "Alternative Flatworm Mitochondrial", {"AAA", 'N'}, {"AGA", 'S'}, {"AGG", 'S'},
+                  {"UAA", 'Y'}, {"UGA", 'W'});
+GENETIC_CODE_SPEC(15, "Blepharisma Nuclear", {"UAG", 'Q'});
+GENETIC_CODE_SPEC(16, "Chlorophycean Mitochondrial", {"UAG", 'L'});
+GENETIC_CODE_SPEC(21, "Trematode Mitochondrial", {"UGA", 'W'}, {"AUA", 'M'}, {"AGA", 'S'}, {"AGG", 'S'},
+                  {"AAA", 'N'});
+GENETIC_CODE_SPEC(22, "Scenedesmus obliquus Mitochondrial", {"UCA", '*'}, {"UAG", 'L'});
+GENETIC_CODE_SPEC(23, "Thraustochytrium Mitochondrial", {"UUA", '*'});
+GENETIC_CODE_SPEC(24, "Rhabdopleuridae Mitochondrial", {"AGA", 'S'}, {"AGG", 'K'}, {"UGA", 'W'});
+GENETIC_CODE_SPEC(25, "Candidate Division SR1 and Gracilibacteria", {"UGA", 'G'});
+GENETIC_CODE_SPEC(26, "Pachysolen tannophilus Nuclear", {"CUG", 'A'});
+GENETIC_CODE_SPEC(27, "Karyorelict Nuclear", {"UAA", 'Q'}, {"UAG", 'Q'}, {"UGA", 'W'});
+GENETIC_CODE_SPEC(28, "Condylostoma Nuclear", {"UAA", 'Q'}, {"UAG", 'Q'}, {"UGA", 'W'});
+GENETIC_CODE_SPEC(29, "Mesodinium Nuclear", {"UAA", 'Y'}, {"UAG", 'Y'});
+GENETIC_CODE_SPEC(30, "Peritrich Nuclear", {"UAA", 'E'}, {"UAG", 'E'});
+GENETIC_CODE_SPEC(31, "Blastocrithidia Nuclear", {"UAA", 'E'}, {"UAG", 'E'}, {"UGA", 'W'});
+GENETIC_CODE_SPEC(33, "Cephalodiscidae Mitochondrial", {"UAA", 'Y'}, {"UGA", 'W'}, {"AGA", 'S'},
+                  {"AGG", 'K'});
+
+#undef GENETIC_CODE_SPEC
+
+// Full table of one code, generated from its spec at compile time
+template<int ID>
+struct GeneticCode {
+  static constexpr array<char, 64> TABLE = BuildCodeTable(GeneticCodeSpec<ID>::OVERRIDES);
+};
+
+// Spot checks against the tables NCBI publishes
+static_assert(TableMatches(GeneticCode<1>::TABLE, STANDARD_CODE_TABLE), "table 1");
+static_assert(TableMatches(GeneticCode<2>::TABLE,
+              "FFLLSSSSYY**CCWWLLLLPPPPHHQQRRRRIIMMTTTTNNKKSS**VVVVAAAADDEEGGGG"), "table 2");
+static_assert(TableMatches(GeneticCode<3>::TABLE,
+              "FFLLSSSSYY**CCWWTTTTPPPPHHQQRRRRIIMMTTTTNNKKSSRRVVVVAAAADDEEGGGG"), "table 3");
+static_assert(TableMatches(GeneticCode<14>::TABLE,
+              "FFLLSSSSYYY*CCWWLLLLPPPPHHQQRRRRIIIMTTTTNNNKSSSSVVVVAAAADDEEGGGG"), "table 14");
+static_assert(TableMatches(GeneticCode<22>::TABLE,
+              "FFLLSS*SYY*LCC*WLLLLPPPPHHQQRRRRIIIMTTTTNNKKSSRRVVVVAAAADDEEGGGG"), "table 22");
+static_assert(TableMatches(GeneticCode<33>::TABLE,
+              "FFLLSSSSYYY*CCWWLLLLPPPPHHQQRRRRIIIMTTTTNNKKSSSKVVVVAAAADDEEGGGG"), "table 33");
+
+#endif
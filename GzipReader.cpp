@@ -0,0 +1,440 @@
+// File:    GzipReader.cpp
+// Author:  Hazael Magino
+// Date:    10/19/2026
+// Section: Section 12
+// E-mail:  hazaelm1@umbc.edu
+// Description: In-process gzip and BGZF decompression for ReadFile. BGZF blocks each
+// carry their compressed and uncompressed sizes, so a batch of them can be inflated
+// independently on several threads and then handed to the parser in file order. The
+// next batch is read and inflated while the parser works through the current one.
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <zlib.h>
+#include "GzipReader.h"
+
+using namespace std;
+
+const int BGZF_HEADER = 18; //Fixed BGZF header size (gzip header plus the BC subfield)
+const int GZIP_TRAILER = 8; //CRC32 and uncompressed size
+const int BGZF_MIN_BLOCK = BGZF_HEADER + GZIP_TRAILER; //Smallest possible block
+const size_t BGZF_MAX_TEXT = 65536; //Largest uncompressed size the BGZF spec allows
+const int BGZF_BATCH = 256; //Blocks inflated per parallel batch (about 16 MB of text)
+const size_t STREAM_CHUNK = 1 << 20; //Bytes read and inflated at a time for plain gzip
+
+  // Name: IsCompressed (static)
+  // Desc: Checks a file for the gzip magic bytes (BGZF files are gzip files too)
+  // Preconditions: None
+  // Postconditions: Returns true if the file starts with 0x1f 0x8b
+bool GzipReader::IsCompressed(const string &fileName){
+
+  FILE *file = fopen(fileName.c_str(), "rb");
+
+  if(file == nullptr){
+
+    return false;
+  }
+
+  unsigned char magic[2] = {0, 0};
+
+  size_t got = fread(magic, 1, 2, file);
+
+  fclose(file);
+
+  return (got == 2) && (magic[0] == 0x1f) && (magic[1] == 0x8b);
+
+}
+
+  // Name: Read (static)
+  // Desc: Decompresses fileName and passes the text to sink in file order.
+  //       BGZF files are inflated a batch of blocks at a time across threads.
+  // Preconditions: fileName is a gzip or BGZF file
+  // Postconditions: Returns true if the whole file was decompressed,
+  //                 false (with error set) otherwise
+bool GzipReader::Read(const string &fileName, int threads, const TextSink &sink, string &error){
+
+  FILE *file = fopen(fileName.c_str(), "rb");
+
+  if(file == nullptr){
+
+    error = "cannot open " + fileName;
+
+    return false;
+  }
+
+  // BGZF is a gzip member with FEXTRA set and a "BC" subfield holding the block size
+
+  unsigned char header[BGZF_HEADER];
+
+  size_t got = fread(header, 1, BGZF_HEADER, file);
+
+  bool bgzf = (got == BGZF_HEADER) && (header[3] & 4) && (header[12] == 'B') && (header[13] == 'C');
+
+  rewind(file);
+
+  bool ok = bgzf ? ReadBgzf(file, threads, sink, error) : ReadStream(file, sink, error);
+
+  fclose(file);
+
+  return ok;
+
+}
+
+  // Name: ReadStart (static)
+  // Desc: Decompresses just the start of fileName (for sniffing the format)
+  // Preconditions: fileName is a gzip or BGZF file
+  // Postconditions: Returns up to size bytes of text (fewer for a short or
+  //                 unreadable file)
+string GzipReader::ReadStart(const string &fileName, size_t size){
+
+  string text(size, '\0');
+
+  gzFile file = gzopen(fileName.c_str(), "rb");
+
+  if(file == nullptr){
+
+    return "";
+  }
+
+  int got = gzread(file, &text[0], size);
+
+  gzclose(file);
+
+  text.resize(max(got, 0));
+
+  return text;
+
+}
+
+  // Name: ReadBgzf (static)
+  // Desc: Splits the file into BGZF blocks and inflates each batch in parallel.
+  //       While one batch is passed to sink, the next is read and inflated.
+  // Preconditions: file is open at the first block
+  // Postconditions: Returns true on success, false (with error set) otherwise
+bool GzipReader::ReadBgzf(FILE *file, int threads, const TextSink &sink, string &error){
+
+  if(threads < 1){
+
+    threads = 1;
+  }
+
+  vector<BgzfBlock> batches[2] = {vector<BgzfBlock>(BGZF_BATCH), vector<BgzfBlock>(BGZF_BATCH)};
+
+  int counts[2] = {0, 0};
+
+  bool done = false;
+
+  if(!ReadBatch(file, batches[0], counts[0], done, error)){
+
+    return false;
+  }
+
+  InflateBatch(batches[0], counts[0], threads);
+
+  int curr = 0; // batch being handed to sink
+
+  while(counts[curr] > 0){
+
+    int ahead = 1 - curr;
+
+    bool aheadOk = true;
+
+    string aheadError = "";
+
+    counts[ahead] = 0;
+
+    // The next batch is read and inflated on the other threads meanwhile
+
+    thread prefetch;
+
+    if(!done){
+
+      prefetch = thread([&](){
+
+        aheadOk = ReadBatch(file, batches[ahead], counts[ahead], done, aheadError);
+
+        if(aheadOk){
+
+          InflateBatch(batches[ahead], counts[ahead], max(threads - 1, 1));
+        }
+      });
+    }
+
+    // Hand the text to the parser in file order
+
+    bool ok = true;
+
+    for(int b = 0; ok && (b < counts[curr]); b++){
+
+      const BgzfBlock &block = batches[curr].at(b);
+
+      if(!block.m_ok){
+
+        error = "corrupt BGZF block";
+
+        ok = false;
+
+      }else if(!block.m_text.empty()){
+
+        sink(block.m_text.data(), block.m_text.length());
+      }
+    }
+
+    if(prefetch.joinable()){
+
+      prefetch.join();
+    }
+
+    if(!ok){
+
+      return false;
+    }
+
+    if(!aheadOk){
+
+      error = aheadError;
+
+      return false;
+    }
+
+    curr = ahead;
+  }
+
+  return true;
+
+}
+
+  // Name: ReadBatch (static)
+  // Desc: Reads up to BGZF_BATCH blocks, checking each block's sizes against the
+  //       BGZF limits before anything is copied or allocated
+  // Preconditions: file is open at a block boundary; batch has BGZF_BATCH entries
+  // Postconditions: Returns false (with error set) on a malformed or truncated
+  //                 block; count holds the blocks read and done is set at the end
+bool GzipReader::ReadBatch(FILE *file, vector<BgzfBlock> &batch, int &count, bool &done, string &error){
+
+  count = 0;
+
+  while(count < BGZF_BATCH){
+
+    unsigned char header[BGZF_HEADER];
+
+    size_t got = fread(header, 1, BGZF_HEADER, file);
+
+    if(got == 0){
+
+      done = true;
+
+      return true;
+    }
+
+    if((got != BGZF_HEADER) || (header[0] != 0x1f) || (header[1] != 0x8b) ||
+       (header[12] != 'B') || (header[13] != 'C')){
+
+      error = "malformed BGZF block header";
+
+      return false;
+    }
+
+    // The block must hold its header, extra field and trailer
+
+    int blockSize = (header[16] | (header[17] << 8)) + 1;
+
+    int xlen = header[10] | (header[11] << 8);
+
+    if((blockSize < BGZF_MIN_BLOCK) || (12 + xlen + GZIP_TRAILER > blockSize)){
+
+      error = "malformed BGZF block size";
+
+      return false;
+    }
+
+    BgzfBlock &block = batch.at(count);
+
+    block.m_compressed.resize(blockSize);
+
+    memcpy(block.m_compressed.data(), header, BGZF_HEADER);
+
+    size_t rest = blockSize - BGZF_HEADER;
+
+    if(fread(block.m_compressed.data() + BGZF_HEADER, 1, rest, file) != rest){
+
+      error = "truncated BGZF block";
+
+      return false;
+    }
+
+    const unsigned char *size = block.m_compressed.data() + blockSize - 4;
+
+    size_t textSize = size[0] | (size[1] << 8) | (size[2] << 16) | ((size_t)size[3] << 24);
+
+    if(textSize > BGZF_MAX_TEXT){
+
+      error = "BGZF block larger than 64 KB";
+
+      return false;
+    }
+
+    count++;
+  }
+
+  return true;
+
+}
+
+  // Name: InflateBatch (static)
+  // Desc: Inflates and CRC checks count blocks of batch across threads
+  // Preconditions: The blocks were read (and size checked) by ReadBatch
+  // Postconditions: Every block has m_text and m_ok set
+void GzipReader::InflateBatch(vector<BgzfBlock> &batch, int count, int threads){
+
+  // Workers claim blocks from a shared counter
+
+  atomic<int> next(0);
+
+  auto worker = [&](){
+
+    for(int b = next++; b < count; b = next++){
+
+      BgzfBlock &block = batch.at(b);
+
+      const unsigned char *data = block.m_compressed.data();
+
+      size_t size = block.m_compressed.size();
+
+      unsigned int xlen = data[10] | (data[11] << 8);
+
+      size_t deflateStart = 12 + xlen;
+
+      uLong crc = data[size - 8] | (data[size - 7] << 8) | (data[size - 6] << 16) | ((uLong)data[size - 5] << 24);
+
+      size_t textSize = data[size - 4] | (data[size - 3] << 8) | (data[size - 2] << 16) | ((size_t)data[size - 1] << 24);
+
+      block.m_text.resize(textSize);
+
+      block.m_ok = false;
+
+      z_stream stream;
+
+      memset(&stream, 0, sizeof(stream));
+
+      if(inflateInit2(&stream, -MAX_WBITS) != Z_OK){
+
+        continue;
+      }
+
+      stream.next_in = const_cast<Bytef *>(data + deflateStart);
+      stream.avail_in = size - deflateStart - GZIP_TRAILER;
+      stream.next_out = (Bytef *)&block.m_text[0];
+      stream.avail_out = textSize;
+
+      int status = (textSize == 0) ? Z_STREAM_END : inflate(&stream, Z_FINISH);
+
+      inflateEnd(&stream);
+
+      block.m_ok = (status == Z_STREAM_END) &&
+                   (crc32(0, (const Bytef *)block.m_text.data(), textSize) == crc);
+    }
+  };
+
+  vector<thread> pool;
+
+  for(int t = 1; t < min(threads, count); t++){
+
+    pool.push_back(thread(worker));
+  }
+
+  worker();
+
+  for(unsigned int t = 0; t < pool.size(); t++){
+
+    pool.at(t).join();
+  }
+
+}
+
+  // Name: ReadStream (static)
+  // Desc: Inflates a (possibly multi-member) gzip stream on one thread
+  // Preconditions: file is open at the first member
+  // Postconditions: Returns true on success, false (with error set) otherwise
+bool GzipReader::ReadStream(FILE *file, const TextSink &sink, string &error){
+
+  vector<unsigned char> input(STREAM_CHUNK);
+
+  vector<char> output(STREAM_CHUNK);
+
+  z_stream stream;
+
+  memset(&stream, 0, sizeof(stream));
+
+  // 32 added to the window bits lets zlib detect and skip the gzip header
+
+  if(inflateInit2(&stream, MAX_WBITS + 32) != Z_OK){
+
+    error = "cannot start zlib";
+
+    return false;
+  }
+
+  int status = Z_OK;
+
+  bool finished = false;
+
+  while(!finished){
+
+    stream.avail_in = fread(input.data(), 1, input.size(), file);
+
+    stream.next_in = input.data();
+
+    if(stream.avail_in == 0){
+
+      break;
+    }
+
+    while(stream.avail_in > 0){
+
+      stream.next_out = (Bytef *)output.data();
+
+      stream.avail_out = output.size();
+
+      status = inflate(&stream, Z_NO_FLUSH);
+
+      if((status != Z_OK) && (status != Z_STREAM_END) && (status != Z_BUF_ERROR)){
+
+        inflateEnd(&stream);
+
+        error = "corrupt gzip data";
+
+        return false;
+      }
+
+      sink(output.data(), output.size() - stream.avail_out);
+
+      if(status == Z_STREAM_END){
+
+        // Concatenated gzip members are read one after another
+
+        inflateReset(&stream);
+
+      }else if((status == Z_BUF_ERROR) && (stream.avail_out != 0)){
+
+        break;
+      }
+    }
+  }
+
+  inflateEnd(&stream);
+
+  if(status != Z_STREAM_END){
+
+    error = "gzip data ended early";
+
+    return false;
+  }
+
+  return true;
+
+}
@@ -0,0 +1,74 @@
+//Title: GzipReader.h
+//Author: Hazael Magino
+//Date: 10/19/2026
+//Description: Reads gzip and BGZF compressed files in-process. BGZF files (independent
+//             deflate blocks of at most 64 KB) are inflated in parallel; plain gzip is
+//             inflated as a stream. Decompressed text is handed to a callback in order,
+//             and BGZF batches are inflated ahead while the callback parses.
+//             Requires zlib (link with -lz).
+
+#ifndef GZIPREADER_H
+#define GZIPREADER_H
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <cstdio>
+using namespace std;
+
+// Receives the next piece of decompressed text
+typedef function<void(const char *data, size_t length)> TextSink;
+
+struct BgzfBlock {
+  vector<unsigned char> m_compressed; //Whole block as read from the file
+  string m_text; //Inflated contents
+  bool m_ok; //Whether inflation and the CRC check succeeded
+};
+
+class GzipReader {
+ public:
+  // Name: IsCompressed (static)
+  // Desc: Checks a file for the gzip magic bytes (BGZF files are gzip files too)
+  // Preconditions: None
+  // Postconditions: Returns true if the file starts with 0x1f 0x8b
+  static bool IsCompressed(const string &fileName);
+  // Name: Read (static)
+  // Desc: Decompresses fileName and passes the text to sink in file order.
+  //       BGZF files are inflated a batch of blocks at a time across threads.
+  // Preconditions: fileName is a gzip or BGZF file
+  // Postconditions: Returns true if the whole file was decompressed,
+  //                 false (with error set) otherwise
+  static bool Read(const string &fileName, int threads, const TextSink &sink, string &error);
+  // Name: ReadStart (static)
+  // Desc: Decompresses just the start of fileName (for sniffing the format)
+  // Preconditions: fileName is a gzip or BGZF file
+  // Postconditions: Returns up to size bytes of text (fewer for a short or
+  //                 unreadable file)
+  static string ReadStart(const string &fileName, size_t size);
+ private:
+  // Name: ReadBgzf (static)
+  // Desc: Splits the file into BGZF blocks and inflates each batch in parallel.
+  //       While one batch is passed to sink, the next is read and inflated.
+  // Preconditions: file is open at the first block
+  // Postconditions: Returns true on success, false (with error set) otherwise
+  static bool ReadBgzf(FILE *file, int threads, const TextSink &sink, string &error);
+  // Name: ReadBatch (static)
+  // Desc: Reads up to BGZF_BATCH blocks, checking each block's sizes against the
+  //       BGZF limits before anything is copied or allocated
+  // Preconditions: file is open at a block boundary; batch has BGZF_BATCH entries
+  // Postconditions: Returns false (with error set) on a malformed or truncated
+  //                 block; count holds the blocks read and done is set at the end
+  static bool ReadBatch(FILE *file, vector<BgzfBlock> &batch, int &count, bool &done, string &error);
+  // Name: InflateBatch (static)
+  // Desc: Inflates and CRC checks count blocks of batch across threads
+  // Preconditions: The blocks were read (and size checked) by ReadBatch
+  // Postconditions: Every block has m_text and m_ok set
+  static void InflateBatch(vector<BgzfBlock> &batch, int count, int threads);
+  // Name: ReadStream (static)
+  // Desc: Inflates a (possibly multi-member) gzip stream on one thread
+  // Preconditions: file is open at the first member
+  // Postconditions: Returns true on success, false (with error set) otherwise
+  static bool ReadStream(FILE *file, const TextSink &sink, string &error);
+};
+
+#endif
@@ -0,0 +1,400 @@
+// File:    NumaTopology.cpp
+// Author:  Hazael Magino
+// Date:    10/19/2026
+// Section: Section 12
+// E-mail:  hazaelm1@umbc.edu
+// Description: NUMA topology and node partitioned parallel loops. On a multi socket
+// host a strand read by a worker on the other socket costs a cross socket transfer
+// for every byte, so each node's workers process the node's own range of strands
+// and only steal from other ranges once theirs is done. Workers are always separate
+// threads (the caller only waits) so pinning never changes the caller's affinity.
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <sched.h>
+#include <dirent.h>
+#include "NumaTopology.h"
+
+using namespace std;
+
+// Parses a kernel CPU list such as "0-3,8-11"
+static vector<int> ParseCPUList(const string &text){
+
+  vector<int> cpus;
+
+  stringstream ranges(text);
+
+  string range;
+
+  while(getline(ranges, range, ',')){
+
+    size_t dash = range.find('-');
+
+    if(range.find_first_of("0123456789") == string::npos){
+
+      continue;
+    }
+
+    int first = atoi(range.c_str());
+
+    int last = (dash == string::npos) ? first : atoi(range.c_str() + dash + 1);
+
+    for(int cpu = first; cpu <= last; cpu++){
+
+      cpus.push_back(cpu);
+    }
+  }
+
+  return cpus;
+
+}
+
+  // Name: NumaTopology (constructor)
+  // Desc: Reads the nodes and their CPU lists under root. Only CPUs this process
+  //       may run on are kept; nodes without any (memory-only nodes) are dropped.
+  //       Without NUMA information the machine is treated as one node.
+  // Preconditions: None
+  // Postconditions: GetNodeCount() >= 1
+NumaTopology::NumaTopology(string root){
+
+  m_enabled = true;
+
+  cpu_set_t allowed;
+
+  CPU_ZERO(&allowed);
+
+  bool haveAllowed = (sched_getaffinity(0, sizeof(allowed), &allowed) == 0);
+
+  DIR *directory = opendir(root.c_str());
+
+  vector<int> ids;
+
+  if(directory != nullptr){
+
+    for(dirent *entry = readdir(directory); entry != nullptr; entry = readdir(directory)){
+
+      string name = entry->d_name;
+
+      if((name.compare(0, 4, "node") == 0) && (name.length() > 4) &&
+         (name.find_first_not_of("0123456789", 4) == string::npos)){
+
+        ids.push_back(atoi(name.c_str() + 4));
+      }
+    }
+
+    closedir(directory);
+  }
+
+  sort(ids.begin(), ids.end());
+
+  for(unsigned int i = 0; i < ids.size(); i++){
+
+    ifstream list(root + "/node" + to_string(ids.at(i)) + "/cpulist");
+
+    string text = "";
+
+    getline(list, text);
+
+    vector<int> cpus;
+
+    vector<int> listed = ParseCPUList(text);
+
+    for(unsigned int c = 0; c < listed.size(); c++){
+
+      if(!haveAllowed || ((listed.at(c) < CPU_SETSIZE) && CPU_ISSET(listed.at(c), &allowed))){
+
+        cpus.push_back(listed.at(c));
+      }
+    }
+
+    if(!cpus.empty()){
+
+      m_nodeIds.push_back(ids.at(i));
+
+      m_cpus.push_back(cpus);
+    }
+  }
+
+  // No NUMA information: one node holding every allowed CPU
+
+  if(m_cpus.empty()){
+
+    vector<int> cpus;
+
+    for(int cpu = 0; haveAllowed && (cpu < CPU_SETSIZE); cpu++){
+
+      if(CPU_ISSET(cpu, &allowed)){
+
+        cpus.push_back(cpu);
+      }
+    }
+
+    m_nodeIds.push_back(0);
+
+    m_cpus.push_back(cpus);
+  }
+
+}
+
+  // Name: GetNodeCount
+  // Preconditions: None
+  // Postconditions: Returns the number of usable nodes (1 when disabled)
+int NumaTopology::GetNodeCount(){
+
+  return m_enabled ? m_cpus.size() : 1;
+
+}
+
+  // Name: GetNodeId
+  // Preconditions: 0 <= node < GetNodeCount()
+  // Postconditions: Returns the kernel's number for the node (nodeN)
+int NumaTopology::GetNodeId(int node){
+
+  return m_nodeIds.at(node);
+
+}
+
+  // Name: SetEnabled
+  // Desc: Turns node partitioning and pinning on or off (off acts like one node)
+  // Preconditions: None
+  // Postconditions: m_enabled is set
+void NumaTopology::SetEnabled(bool enabled){
+
+  m_enabled = enabled;
+
+}
+
+  // Name: AssignWorkers
+  // Desc: Spreads threads workers over the nodes in proportion to their CPUs,
+  //       giving every node at least one worker when there are enough
+  // Preconditions: threads >= 1
+  // Postconditions: Returns the node of each worker
+vector<int> NumaTopology::AssignWorkers(int threads){
+
+  int nodes = GetNodeCount();
+
+  size_t totalCPUs = 0;
+
+  for(int n = 0; n < nodes; n++){
+
+    totalCPUs += max(m_cpus.at(n).size(), size_t(1));
+  }
+
+  // Worker t goes to the node whose share of the CPUs covers position t
+
+  vector<int> workerNodes;
+
+  for(int t = 0; t < threads; t++){
+
+    if(threads < nodes * 2){
+
+      // Few workers: one per node first, round robin
+
+      workerNodes.push_back(t % nodes);
+
+      continue;
+    }
+
+    size_t position = (size_t(t) * totalCPUs + totalCPUs / 2) / threads;
+
+    int node = 0;
+
+    size_t covered = max(m_cpus.at(0).size(), size_t(1));
+
+    while((position >= covered) && (node + 1 < nodes)){
+
+      node++;
+
+      covered += max(m_cpus.at(node).size(), size_t(1));
+    }
+
+    workerNodes.push_back(node);
+  }
+
+  return workerNodes;
+
+}
+
+  // Name: Partition
+  // Desc: Splits items (with the given weights) into one contiguous range per
+  //       node, sized by each node's share of the workers
+  // Preconditions: workerNodes came from AssignWorkers
+  // Postconditions: Returns GetNodeCount() + 1 bounds; node n owns [bounds[n], bounds[n + 1])
+vector<size_t> NumaTopology::Partition(const vector<size_t> &weights, const vector<int> &workerNodes){
+
+  int nodes = GetNodeCount();
+
+  vector<size_t> workersOn(nodes, 0);
+
+  for(unsigned int t = 0; t < workerNodes.size(); t++){
+
+    workersOn.at(workerNodes.at(t))++;
+  }
+
+  uint64_t total = 0;
+
+  for(unsigned int i = 0; i < weights.size(); i++){
+
+    total += weights.at(i) + 1; // +1 so empty strands still spread out
+  }
+
+  // Close each node's range once the running weight reaches its share
+
+  vector<size_t> bounds(1, 0);
+
+  uint64_t running = 0;
+
+  size_t item = 0;
+
+  size_t workersBefore = 0;
+
+  for(int n = 0; n < nodes; n++){
+
+    workersBefore += workersOn.at(n);
+
+    uint64_t target = (workerNodes.empty()) ? total : total * workersBefore / workerNodes.size();
+
+    while((item < weights.size()) && ((running < target) || (n == nodes - 1))){
+
+      running += weights.at(item) + 1;
+
+      item++;
+    }
+
+    bounds.push_back(item);
+  }
+
+  return bounds;
+
+}
+
+  // Name: Pin
+  // Desc: Restricts the calling thread to the CPUs of node
+  // Preconditions: 0 <= node < GetNodeCount()
+  // Postconditions: Returns false if the affinity could not be set
+bool NumaTopology::Pin(int node){
+
+  const vector<int> &cpus = m_cpus.at(node);
+
+  if(cpus.empty()){
+
+    return false;
+  }
+
+  cpu_set_t set;
+
+  CPU_ZERO(&set);
+
+  for(unsigned int c = 0; c < cpus.size(); c++){
+
+    CPU_SET(cpus.at(c), &set);
+  }
+
+  // pid 0 is the calling thread
+
+  return (sched_setaffinity(0, sizeof(set), &set) == 0);
+
+}
+
+  // Name: ForEach
+  // Desc: Calls work(i) for every item on threads pinned workers. Worker threads
+  //       allocate what they create on their own node (first touch), so a stage
+  //       that writes per item output keeps it next to the node that reads it later.
+  // Preconditions: work is safe to call from several threads for different items
+  // Postconditions: work ran once per item; counters holds one entry per node
+void NumaTopology::ForEach(const vector<size_t> &weights, int threads, const function<void(size_t)> &work,
+                           vector<NodeCounters> &counters){
+
+  int nodes = GetNodeCount();
+
+  threads = max(threads, 1);
+
+  vector<int> workerNodes = AssignWorkers(threads);
+
+  vector<size_t> bounds = Partition(weights, workerNodes);
+
+  // One cursor per node range
+
+  vector<atomic<size_t> > next(nodes);
+
+  for(int n = 0; n < nodes; n++){
+
+    next.at(n) = bounds.at(n);
+  }
+
+  counters.assign(nodes, NodeCounters());
+
+  vector<NodeCounters> perWorker(threads, NodeCounters());
+
+  auto worker = [&](int id){
+
+    int home = workerNodes.at(id);
+
+    NodeCounters &mine = perWorker.at(id);
+
+    if((nodes > 1) && m_enabled){
+
+      Pin(home);
+    }
+
+    auto start = chrono::steady_clock::now();
+
+    // Own node first, then the other nodes in order
+
+    for(int step = 0; step < nodes; step++){
+
+      int node = (home + step) % nodes;
+
+      for(size_t i = next.at(node)++; i < bounds.at(node + 1); i = next.at(node)++){
+
+        work(i);
+
+        mine.m_items++;
+
+        mine.m_bytes += weights.at(i);
+
+        if(node != home){
+
+          mine.m_remoteItems++;
+        }
+      }
+    }
+
+    mine.m_busySeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+  };
+
+  // Every worker is a new thread, so pinning never sticks to the caller
+
+  vector<thread> pool;
+
+  for(int t = 0; t < threads; t++){
+
+    pool.push_back(thread(worker, t));
+  }
+
+  for(unsigned int t = 0; t < pool.size(); t++){
+
+    pool.at(t).join();
+  }
+
+  for(int t = 0; t < threads; t++){
+
+    NodeCounters &total = counters.at(workerNodes.at(t));
+
+    total.m_items += perWorker.at(t).m_items;
+
+    total.m_remoteItems += perWorker.at(t).m_remoteItems;
+
+    total.m_bytes += perWorker.at(t).m_bytes;
+
+    total.m_busySeconds += perWorker.at(t).m_busySeconds;
+  }
+
+}
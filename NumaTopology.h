@@ -0,0 +1,80 @@
+//Title: NumaTopology.h
+//Author: Hazael Magino
+//Date: 10/19/2026
+//Description: NUMA layout of the machine (read from /sys/devices/system/node) and a
+//             parallel loop that keeps work on the node that holds its memory. Items
+//             are split into one contiguous range per node, weighted by the node's
+//             share of the workers; each worker is pinned to its node's CPUs, works
+//             through its own node's range first and only then helps other nodes.
+
+#ifndef NUMATOPOLOGY_H
+#define NUMATOPOLOGY_H
+
+#include <vector>
+#include <string>
+#include <functional>
+#include <cstdint>
+using namespace std;
+
+// Work done by the workers of one node during a NUMA partitioned loop
+struct NodeCounters {
+  uint64_t m_items; //Items processed
+  uint64_t m_remoteItems; //Items taken from another node's range
+  uint64_t m_bytes; //Weight (bytes of bases) of the items processed
+  double m_busySeconds; //Time the node's workers spent processing, summed
+};
+
+class NumaTopology {
+ public:
+  // Name: NumaTopology (constructor)
+  // Desc: Reads the nodes and their CPU lists under root. Only CPUs this process
+  //       may run on are kept; nodes without any (memory-only nodes) are dropped.
+  //       Without NUMA information the machine is treated as one node.
+  // Preconditions: None
+  // Postconditions: GetNodeCount() >= 1
+  NumaTopology(string root = "/sys/devices/system/node");
+  // Name: GetNodeCount
+  // Preconditions: None
+  // Postconditions: Returns the number of usable nodes (1 when disabled)
+  int GetNodeCount();
+  // Name: GetNodeId
+  // Preconditions: 0 <= node < GetNodeCount()
+  // Postconditions: Returns the kernel's number for the node (nodeN)
+  int GetNodeId(int node);
+  // Name: SetEnabled
+  // Desc: Turns node partitioning and pinning on or off (off acts like one node)
+  // Preconditions: None
+  // Postconditions: m_enabled is set
+  void SetEnabled(bool enabled);
+  // Name: AssignWorkers
+  // Desc: Spreads threads workers over the nodes in proportion to their CPUs,
+  //       giving every node at least one worker when there are enough
+  // Preconditions: threads >= 1
+  // Postconditions: Returns the node of each worker
+  vector<int> AssignWorkers(int threads);
+  // Name: Partition
+  // Desc: Splits items (with the given weights) into one contiguous range per
+  //       node, sized by each node's share of the workers
+  // Preconditions: workerNodes came from AssignWorkers
+  // Postconditions: Returns GetNodeCount() + 1 bounds; node n owns [bounds[n], bounds[n + 1])
+  vector<size_t> Partition(const vector<size_t> &weights, const vector<int> &workerNodes);
+  // Name: Pin
+  // Desc: Restricts the calling thread to the CPUs of node
+  // Preconditions: 0 <= node < GetNodeCount()
+  // Postconditions: Returns false if the affinity could not be set
+  bool Pin(int node);
+  // Name: ForEach
+  // Desc: Calls work(i) for every item on threads pinned workers. Worker threads
+  //       allocate what they create on their own node (first touch), so a stage
+  //       that writes per item output keeps it next to the node that reads it later.
+  // Preconditions: work is safe to call from several threads for different items
+  // Postconditions: work ran once per item; counters holds one entry per node
+  void ForEach(const vector<size_t> &weights, int threads, const function<void(size_t)> &work,
+               vector<NodeCounters> &counters);
+ private:
+  vector<int> m_nodeIds; //Kernel number of each usable node
+  vector<vector<int> > m_cpus; //Allowed CPUs of each usable node
+  bool m_enabled; //Partition and pin (otherwise act like one node)
+};
+
+#endif
@@ -0,0 +1,187 @@
+// File:    Protein.cpp
+// Author:  Hazael Magino
+// Date:    10/19/2026
+// Section: Section 12
+// E-mail:  hazaelm1@umbc.edu
+// Description: Stores translated mRNA as one byte per residue so a translation only has
+// to run once. Proteins can be written out as FASTA or summarized by composition.
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include "Protein.h"
+#include "SequencerCore.h"
+
+using namespace std;
+
+const int FASTA_WIDTH = 60; //Residues per FASTA line
+
+  // Name: Protein (constructor)
+  // Desc: Builds an empty protein linked to the mRNA strand it came from
+  // Preconditions: source is the index of the strand in m_mRNA
+  // Postconditions: Creates a protein with no residues
+Protein::Protein(string name, int source){
+
+  m_name = name;
+
+  m_source = source;
+
+}
+
+  // Name: Translate (static)
+  // Desc: Translates size bases of mRNA, three at a time, into a new protein
+  //       using NCBI genetic code `code`. Incomplete trailing codons are ignored
+  // Preconditions: bases holds U, A, G, or C; code is a valid genetic code
+  // Postconditions: Returns a new dynamically allocated protein
+Protein *Protein::Translate(string name, int source, const char *bases, int size, int code){
+
+  Protein *protein = new Protein(name, source);
+
+  protein->m_residues.resize(size / 3);
+
+  BaseSpan input = {bases, size_t(size)};
+
+  OutputSpan output = {&protein->m_residues[0], protein->m_residues.size(), 0};
+
+  // Codons with bad bases come back as 'X'; the protein is kept either way
+
+  CoreTranslate(input, output, code);
+
+  return protein;
+
+}
+
+  // Name: CodonToResidue (static)
+  // Desc: Looks up the one-letter code of a codon in the standard genetic code
+  // Preconditions: codon points at three chars
+  // Postconditions: Returns the residue, '*' for Stop or 'X' for unknown codons
+char Protein::CodonToResidue(const char *codon){
+
+  return CoreCodonToResidue(codon);
+
+}
+
+  // Name: ResidueName (static)
+  // Desc: Converts a one-letter code back to the name Convert displays
+  // Preconditions: None
+  // Postconditions: Returns the amino acid name or "Unknown"
+string Protein::ResidueName(char residue){
+
+  return CoreResidueName(residue);
+
+}
+
+  // Name: AddResidue
+  // Preconditions: None
+  // Postconditions: Appends residue to the protein
+void Protein::AddResidue(char residue){
+
+  m_residues += residue;
+
+}
+
+  // Name: GetName
+  // Preconditions: None
+  // Postconditions: Returns m_name
+string Protein::GetName(){
+
+  return m_name;
+
+}
+
+  // Name: GetSource
+  // Preconditions: None
+  // Postconditions: Returns the index of the source mRNA strand
+int Protein::GetSource(){
+
+  return m_source;
+
+}
+
+  // Name: GetSize
+  // Preconditions: None
+  // Postconditions: Returns the number of residues (including stops)
+int Protein::GetSize(){
+
+  return m_residues.length();
+
+}
+
+  // Name: GetResidue
+  // Preconditions: None
+  // Postconditions: Returns the residue at index or '\0' if out of range
+char Protein::GetResidue(int index){
+
+  if((index < 0) || (index >= int(m_residues.length()))){
+
+    return '\0';
+  }
+
+  return m_residues[index];
+
+}
+
+  // Name: GetSequence
+  // Preconditions: None
+  // Postconditions: Returns all residues as one string
+const string &Protein::GetSequence(){
+
+  return m_residues;
+
+}
+
+  // Name: WriteFasta
+  // Desc: Writes the protein as a FASTA record (">name" then 60 residues a line)
+  //       The record is built in memory and written in one call
+  // Preconditions: output is open
+  // Postconditions: Record is written to output
+void Protein::WriteFasta(ostream &output){
+
+  string record;
+
+  record.reserve(m_name.length() + m_residues.length() + m_residues.length() / FASTA_WIDTH + 4);
+
+  record += '>';
+
+  record += m_name;
+
+  record += '\n';
+
+  for(unsigned int i = 0; i < m_residues.length(); i += FASTA_WIDTH){
+
+    record.append(m_residues, i, FASTA_WIDTH);
+
+    record += '\n';
+  }
+
+  output.write(record.data(), record.length());
+
+}
+
+  // Name: WriteSummary
+  // Desc: Writes the length and how many of each residue the protein has
+  // Preconditions: output is open
+  // Postconditions: Summary is written to output
+void Protein::WriteSummary(ostream &output){
+
+  int counts[256] = {0};
+
+  for(unsigned int i = 0; i < m_residues.length(); i++){
+
+    counts[(unsigned char)m_residues[i]]++;
+  }
+
+  output << m_name << ": " << m_residues.length() << " residue(s)" << endl;
+
+  // One line per residue that occurs, in alphabetical order
+
+  for(int residue = 0; residue < 256; residue++){
+
+    if(counts[residue] > 0){
+
+      output << "  " << char(residue) << " " << left << setw(20) << ResidueName(residue)
+             << right << setw(6) << counts[residue] << endl;
+    }
+  }
+
+}
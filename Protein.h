@@ -0,0 +1,81 @@
+//Title: Protein.h
+//Author: Hazael Magino
+//Date: 10/19/2026
+//Description: Stores the result of translating an mRNA strand as one byte per residue
+//             (one-letter amino acid codes, '*' for Stop) so it can be reused after
+//             translation instead of only being displayed.
+
+#ifndef PROTEIN_H
+#define PROTEIN_H
+
+#include <string>
+#include <iostream>
+#include "GeneticCode.h"
+using namespace std;
+
+class Protein {
+ public:
+  // Name: Protein (constructor)
+  // Desc: Builds an empty protein linked to the mRNA strand it came from
+  // Preconditions: source is the index of the strand in m_mRNA
+  // Postconditions: Creates a protein with no residues
+  Protein(string name, int source);
+  // Name: Translate (static)
+  // Desc: Translates size bases of mRNA, three at a time, into a new protein
+  //       using NCBI genetic code `code`. Incomplete trailing codons are ignored
+  // Preconditions: bases holds U, A, G, or C; code is a valid genetic code
+  // Postconditions: Returns a new dynamically allocated protein
+  static Protein *Translate(string name, int source, const char *bases, int size,
+                            int code = DEFAULT_GENETIC_CODE);
+  // Name: CodonToResidue (static)
+  // Desc: Looks up the one-letter code of a codon in the standard genetic code
+  // Preconditions: codon points at three chars
+  // Postconditions: Returns the residue, '*' for Stop or 'X' for unknown codons
+  static char CodonToResidue(const char *codon);
+  // Name: ResidueName (static)
+  // Desc: Converts a one-letter code back to the name Convert displays
+  // Preconditions: None
+  // Postconditions: Returns the amino acid name or "Unknown"
+  static string ResidueName(char residue);
+  // Name: AddResidue
+  // Preconditions: None
+  // Postconditions: Appends residue to the protein
+  void AddResidue(char residue);
+  // Name: GetName
+  // Preconditions: None
+  // Postconditions: Returns m_name
+  string GetName();
+  // Name: GetSource
+  // Preconditions: None
+  // Postconditions: Returns the index of the source mRNA strand
+  int GetSource();
+  // Name: GetSize
+  // Preconditions: None
+  // Postconditions: Returns the number of residues (including stops)
+  int GetSize();
+  // Name: GetResidue
+  // Preconditions: None
+  // Postconditions: Returns the residue at index or '\0' if out of range
+  char GetResidue(int index);
+  // Name: GetSequence
+  // Preconditions: None
+  // Postconditions: Returns all residues as one string
+  const string &GetSequence();
+  // Name: WriteFasta
+  // Desc: Writes the protein as a FASTA record (">name" then 60 residues a line)
+  //       The record is built in memory and written in one call
+  // Preconditions: output is open
+  // Postconditions: Record is written to output
+  void WriteFasta(ostream &output);
+  // Name: WriteSummary
+  // Desc: Writes the length and how many of each residue the protein has
+  // Preconditions: output is open
+  // Postconditions: Summary is written to output
+  void WriteSummary(ostream &output);
+ private:
+  string m_name; //Name of the protein (same as its mRNA strand)
+  int m_source; //Index of the source strand in m_mRNA
+  string m_residues; //One byte per residue
+};
+
+#endif
@@ -0,0 +1,360 @@
+// File:    RecordIndex.cpp
+// Author:  Hazael Magino
+// Date:    10/19/2026
+// Section: Section 12
+// E-mail:  hazaelm1@umbc.edu
+// Description: Record index for lazy loading. The scan only looks for line breaks and
+// the first comma of each line and counts bases; nothing is copied except the names.
+// The sidecar is a small binary file tagged with the input's size and modification
+// time, so an edited input is rescanned instead of being read at stale offsets.
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <cstring>
+#include <cstdio>
+#include <sys/stat.h>
+#include "RecordIndex.h"
+
+using namespace std;
+
+const char INDEX_MAGIC[8] = {'S', 'E', 'Q', 'I', 'D', 'X', '2', '\0'}; //Sidecar format tag
+const size_t INDEX_CHUNK = 1 << 20; //Bytes scanned at a time
+
+  // Name: RecordIndex (constructor)
+  // Preconditions: None
+  // Postconditions: Creates an empty index
+RecordIndex::RecordIndex(){
+
+  m_fileSize = 0;
+
+  m_fileTime = 0;
+
+  m_built = false;
+
+}
+
+  // Name: Load
+  // Desc: Loads fileName + ".idx" if it matches the file's size and modification
+  //       time; otherwise scans the file and writes a new sidecar
+  // Preconditions: fileName is an uncompressed strand file
+  // Postconditions: Returns false with error set if the file cannot be read;
+  //                 a sidecar that cannot be written is not an error
+bool RecordIndex::Load(string fileName, string &error){
+
+  struct stat info;
+
+  if(stat(fileName.c_str(), &info) != 0){
+
+    error = "error reading " + fileName;
+
+    return false;
+  }
+
+  m_fileSize = info.st_size;
+
+  // Whole seconds would miss an edit made within a second of the last scan
+
+  m_fileTime = int64_t(info.st_mtim.tv_sec) * 1000000000 + info.st_mtim.tv_nsec;
+
+  if(ReadSidecar(fileName + ".idx")){
+
+    m_built = false;
+
+    return true;
+  }
+
+  if(!Build(fileName, error)){
+
+    return false;
+  }
+
+  m_built = true;
+
+  WriteSidecar(fileName + ".idx");
+
+  return true;
+
+}
+
+  // Name: GetEntries
+  // Preconditions: Load has succeeded
+  // Postconditions: Returns the records in file order
+const vector<IndexEntry> &RecordIndex::GetEntries(){
+
+  return m_entries;
+
+}
+
+  // Name: WasBuilt
+  // Preconditions: Load has succeeded
+  // Postconditions: Returns true if the file was scanned, false if the sidecar was used
+bool RecordIndex::WasBuilt(){
+
+  return m_built;
+
+}
+
+  // Name: ParseRecord (static)
+  // Desc: Extracts the bases of a record line (everything after the first comma,
+  //       without commas and carriage returns)
+  // Preconditions: output has room for capacity bases
+  // Postconditions: Returns the number of bases written, or capacity + 1 (with
+  //                 capacity written) if the record holds more than capacity
+size_t RecordIndex::ParseRecord(const char *line, size_t length, char *output, size_t capacity){
+
+  const char *comma = (const char *)memchr(line, ',', length);
+
+  size_t count = 0;
+
+  if(comma == nullptr){
+
+    return 0;
+  }
+
+  for(const char *curr = comma + 1; curr < line + length; curr++){
+
+    if((*curr != ',') && (*curr != '\r')){
+
+      // A record edited since it was indexed may hold more bases than output
+
+      if(count == capacity){
+
+        return capacity + 1;
+      }
+
+      output[count++] = *curr;
+    }
+  }
+
+  return count;
+
+}
+
+  // Name: Build
+  // Desc: Scans the file once and records every line that holds a record
+  // Preconditions: None
+  // Postconditions: Returns false with error set if the file cannot be read
+bool RecordIndex::Build(string fileName, string &error){
+
+  ifstream inputData(fileName, ios::binary);
+
+  if(!inputData.is_open()){
+
+    error = "error reading " + fileName;
+
+    return false;
+  }
+
+  m_entries.clear();
+
+  vector<char> buffer(INDEX_CHUNK);
+
+  uint64_t chunkOffset = 0; // file offset of buffer[0]
+
+  // State of the line being scanned; it may span several chunks
+
+  IndexEntry entry = {"", 0, 0, 0};
+
+  bool inName = true;
+
+  bool isRecord = false;
+
+  auto finishLine = [&](uint64_t end){
+
+    entry.m_length = end - entry.m_offset;
+
+    if(isRecord){
+
+      m_entries.push_back(entry);
+    }
+
+    entry.m_name.clear();
+
+    entry.m_offset = end + 1;
+
+    entry.m_bases = 0;
+
+    inName = true;
+
+    isRecord = false;
+  };
+
+  while(inputData.read(buffer.data(), INDEX_CHUNK) || (inputData.gcount() > 0)){
+
+    size_t length = inputData.gcount();
+
+    for(size_t i = 0; i < length; i++){
+
+      char curr = buffer[i];
+
+      if(curr == '\n'){
+
+        finishLine(chunkOffset + i);
+
+      }else if(inName){
+
+        if(curr == ','){
+
+          inName = false;
+
+          isRecord = true;
+
+        }else{
+
+          entry.m_name += curr;
+        }
+
+      }else if(curr != '\r' && curr != ','){
+
+        entry.m_bases++;
+      }
+    }
+
+    chunkOffset += length;
+  }
+
+  // The last record may not end with a line break
+
+  if(chunkOffset > entry.m_offset){
+
+    finishLine(chunkOffset);
+  }
+
+  return true;
+
+}
+
+  // Name: ReadSidecar
+  // Preconditions: None
+  // Postconditions: Returns true if the sidecar exists, matches and was loaded
+bool RecordIndex::ReadSidecar(string sidecar){
+
+  ifstream inputData(sidecar, ios::binary);
+
+  if(!inputData.is_open()){
+
+    return false;
+  }
+
+  char magic[8];
+
+  uint64_t fileSize = 0;
+
+  int64_t fileTime = 0;
+
+  uint64_t count = 0;
+
+  inputData.read(magic, sizeof(magic));
+
+  inputData.read((char *)&fileSize, sizeof(fileSize));
+
+  inputData.read((char *)&fileTime, sizeof(fileTime));
+
+  inputData.read((char *)&count, sizeof(count));
+
+  if(!inputData || (memcmp(magic, INDEX_MAGIC, sizeof(magic)) != 0) ||
+     (fileSize != m_fileSize) || (fileTime != m_fileTime)){
+
+    return false;
+  }
+
+  // Every record takes at least a byte of the file, so a larger count is corrupt
+
+  if(count > m_fileSize){
+
+    return false;
+  }
+
+  m_entries.clear();
+
+  m_entries.reserve(count);
+
+  for(uint64_t i = 0; i < count; i++){
+
+    IndexEntry entry;
+
+    uint16_t nameLength = 0;
+
+    inputData.read((char *)&entry.m_offset, sizeof(entry.m_offset));
+
+    inputData.read((char *)&entry.m_length, sizeof(entry.m_length));
+
+    inputData.read((char *)&entry.m_bases, sizeof(entry.m_bases));
+
+    inputData.read((char *)&nameLength, sizeof(nameLength));
+
+    entry.m_name.resize(nameLength);
+
+    inputData.read(&entry.m_name[0], nameLength);
+
+    // A truncated sidecar is rebuilt rather than trusted
+
+    if(!inputData || (entry.m_offset + entry.m_length > m_fileSize)){
+
+      m_entries.clear();
+
+      return false;
+    }
+
+    m_entries.push_back(entry);
+  }
+
+  return true;
+
+}
+
+  // Name: WriteSidecar
+  // Desc: Writes the sidecar atomically (temporary file, then rename)
+  // Preconditions: m_entries is built
+  // Postconditions: Returns true if the sidecar was written
+bool RecordIndex::WriteSidecar(string sidecar){
+
+  string tempFile = sidecar + ".tmp";
+
+  ofstream outputData(tempFile, ios::binary);
+
+  if(!outputData.is_open()){
+
+    return false;
+  }
+
+  uint64_t count = m_entries.size();
+
+  outputData.write(INDEX_MAGIC, sizeof(INDEX_MAGIC));
+
+  outputData.write((const char *)&m_fileSize, sizeof(m_fileSize));
+
+  outputData.write((const char *)&m_fileTime, sizeof(m_fileTime));
+
+  outputData.write((const char *)&count, sizeof(count));
+
+  for(unsigned int i = 0; i < m_entries.size(); i++){
+
+    const IndexEntry &entry = m_entries.at(i);
+
+    uint16_t nameLength = min(entry.m_name.length(), size_t(0xFFFF));
+
+    outputData.write((const char *)&entry.m_offset, sizeof(entry.m_offset));
+
+    outputData.write((const char *)&entry.m_length, sizeof(entry.m_length));
+
+    outputData.write((const char *)&entry.m_bases, sizeof(entry.m_bases));
+
+    outputData.write((const char *)&nameLength, sizeof(nameLength));
+
+    outputData.write(entry.m_name.data(), nameLength);
+  }
+
+  outputData.close();
+
+  if(outputData.fail() || (rename(tempFile.c_str(), sidecar.c_str()) != 0)){
+
+    remove(tempFile.c_str());
+
+    return false;
+  }
+
+  return true;
+
+}
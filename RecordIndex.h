@@ -0,0 +1,73 @@
+//Title: RecordIndex.h
+//Author: Hazael Magino
+//Date: 10/19/2026
+//Description: Offset index of the records in an uncompressed strand file (name, byte
+//             offset, line length and number of bases). The index is built by one scan
+//             of the file and saved next to it as a .idx sidecar, so later runs load
+//             it without reading the records at all.
+
+#ifndef RECORDINDEX_H
+#define RECORDINDEX_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+using namespace std;
+
+struct IndexEntry {
+  string m_name; //Strand name
+  uint64_t m_offset; //Byte offset of the record's line
+  uint32_t m_length; //Bytes in the line (without the line break)
+  uint32_t m_bases; //Bases in the record (commas and carriage returns excluded)
+};
+
+class RecordIndex {
+ public:
+  // Name: RecordIndex (constructor)
+  // Preconditions: None
+  // Postconditions: Creates an empty index
+  RecordIndex();
+  // Name: Load
+  // Desc: Loads fileName + ".idx" if it matches the file's size and modification
+  //       time; otherwise scans the file and writes a new sidecar
+  // Preconditions: fileName is an uncompressed strand file
+  // Postconditions: Returns false with error set if the file cannot be read;
+  //                 a sidecar that cannot be written is not an error
+  bool Load(string fileName, string &error);
+  // Name: GetEntries
+  // Preconditions: Load has succeeded
+  // Postconditions: Returns the records in file order
+  const vector<IndexEntry> &GetEntries();
+  // Name: WasBuilt
+  // Preconditions: Load has succeeded
+  // Postconditions: Returns true if the file was scanned, false if the sidecar was used
+  bool WasBuilt();
+  // Name: ParseRecord (static)
+  // Desc: Extracts the bases of a record line (everything after the first comma,
+  //       without commas and carriage returns)
+  // Preconditions: output has room for capacity bases
+  // Postconditions: Returns the number of bases written, or capacity + 1 (with
+  //                 capacity written) if the record holds more than capacity
+  static size_t ParseRecord(const char *line, size_t length, char *output, size_t capacity);
+ private:
+  // Name: Build
+  // Desc: Scans the file once and records every line that holds a record
+  // Preconditions: None
+  // Postconditions: Returns false with error set if the file cannot be read
+  bool Build(string fileName, string &error);
+  // Name: ReadSidecar
+  // Preconditions: None
+  // Postconditions: Returns true if the sidecar exists, matches and was loaded
+  bool ReadSidecar(string sidecar);
+  // Name: WriteSidecar
+  // Desc: Writes the sidecar atomically (temporary file, then rename)
+  // Preconditions: m_entries is built
+  // Postconditions: Returns true if the sidecar was written
+  bool WriteSidecar(string sidecar);
+  vector<IndexEntry> m_entries; //Records in file order
+  uint64_t m_fileSize; //Size of the indexed file
+  int64_t m_fileTime; //Modification time of the indexed file in nanoseconds
+  bool m_built; //The index came from a scan
+};
+
+#endif
@@ -17,10 +17,98 @@
 #include <string>
 #include "Sequencer.h"
 #include "Strand.h"
+#include "Protein.h"
+#include "CodonProfile.h"
+#include "GzipReader.h"
+#include "SequencerServer.h"
+#include "ShardRunner.h"
+#include "VariantEngine.h"
+#include "BatchJob.h"
+#include "StrandCache.h"
+#include "SketchCluster.h"
+#include "SequencerCore.h"
+#include "NumaTopology.h"
+#include <cstring>
+#include <chrono>
+#include <thread>
+#include <limits>
 
 
 using namespace std;
 
+// True if the first non blank character of the text starts a FASTQ header
+static bool LooksLikeFastq(const char *data, size_t length){
+
+  for(size_t i = 0; i < length; i++){
+
+    if(!isspace((unsigned char)data[i])){
+
+      return (data[i] == '@');
+    }
+  }
+
+  return false;
+
+}
+
+// LooksLikeFastq for the start of a file (decompressed first if it is gzip)
+static bool FileLooksLikeFastq(const string &fileName){
+
+  char start[4096];
+
+  if(GzipReader::IsCompressed(fileName)){
+
+    string text = GzipReader::ReadStart(fileName, sizeof(start));
+
+    return LooksLikeFastq(text.data(), text.length());
+  }
+
+  ifstream inputData(fileName, ios::binary);
+
+  inputData.read(start, sizeof(start));
+
+  return LooksLikeFastq(start, inputData.gcount());
+
+}
+
+// 64-bit hash of a record's bases, 8 bytes per step, used to find duplicate records
+static uint64_t ContentHash(const string &bases){
+
+  const uint64_t MULTIPLIER = 0xFF51AFD7ED558CCDULL;
+
+  uint64_t hash = 0x9E3779B97F4A7C15ULL ^ bases.length();
+
+  size_t i = 0;
+
+  for(; i + 8 <= bases.length(); i += 8){
+
+    uint64_t word;
+
+    memcpy(&word, bases.data() + i, 8);
+
+    hash = (hash ^ word) * MULTIPLIER;
+
+    hash ^= hash >> 32;
+  }
+
+  uint64_t tail = 0;
+
+  memcpy(&tail, bases.data() + i, bases.length() - i);
+
+  hash = (hash ^ tail) * MULTIPLIER;
+
+  // Final mix so every input bit reaches the low bits used by the hash map
+
+  hash ^= hash >> 33;
+
+  hash *= 0xC4CEB9FE1A85EC53ULL;
+
+  hash ^= hash >> 33;
+
+  return hash;
+
+}
+
 
   // Name: Sequencer (constructor)
   // Desc: Creates a new sequencer to hold one or more DNA/mRNA strands make of
@@ -34,6 +122,44 @@ Sequencer::Sequencer(string fileName){
 
 m_fileName = fileName;
 
+m_compress = false;
+
+m_threads = 1;
+
+m_shards = 1;
+
+m_shardByHash = false;
+
+m_variantFile = "";
+
+m_checkpointSeconds = 5;
+
+m_memoryBudget = 0;
+
+m_lazy = false;
+
+m_dedup = false;
+
+m_duplicates = 0;
+
+m_publish = false;
+
+m_fastq = false;
+
+m_fastqLine = 0;
+
+m_snapshot = nullptr;
+
+m_cache = nullptr;
+
+m_clusterANI = 0.95;
+
+m_geneticCode = DEFAULT_GENETIC_CODE;
+
+m_cohort = nullptr;
+
+m_mRNACohort = nullptr;
+
 }
 
 
@@ -65,6 +191,24 @@ for (unsigned int i = 0; i < m_mRNA.size(); i++){
 
 }
 
+cout << "Deleting Proteins" << endl;
+
+for (unsigned int i = 0; i < m_protein.size(); i++){
+
+  delete m_protein.at(i);
+
+}
+
+// Compressed strands live in the cohorts
+
+delete m_cohort;
+
+delete m_mRNACohort;
+
+// Every cached strand is gone by now
+
+delete m_cache;
+
   
 }
 
@@ -84,16 +228,47 @@ ReadFile();
 
   //Print out the number of DNA strands loaded in
 
-cout  << m_DNA.size() << " Strand(s) loaded\n" << endl;
+cout  << GetDNACount() << " Strand(s) loaded\n" << endl;
+
+if(m_variantFile != ""){
+
+  ApplyVariants();
+}
+
+PlaceStrands();
+
+if(m_cohort != nullptr){
+
+  // Compare against what the same strands cost as plain strands (one Strand
+  // plus a contiguous buffer of its bases each)
+
+  size_t plainBytes = 0;
+
+  for(int i = 0; i < m_cohort->GetCount(); i++){
+
+    plainBytes += sizeof(Strand) + m_cohort->GetSize(i);
+  }
+
+  cout << "Compressed against a reference: " << m_cohort->GetMemoryUsage()
+       << " bytes (" << plainBytes << " bytes uncompressed)\n" << endl;
+}
 
   // Continously call the main menu function
 
+ReportCache();
+
 do{
     
   state = MainMenu();
 
+  // Strands paged in by the last action may push the cache over its budget
+
+  EnforceBudget();
+
 }while(state == 0);
 
+ReportCache();
+
 }
 
   // Name: DisplayStrands
@@ -104,6 +279,45 @@ do{
   // Postconditions: Displays DNA strand from one of the vectors
 void Sequencer::DisplayStrands(){
 
+if(m_cohort != nullptr){
+
+  // Compressed strands are decoded one at a time for display
+
+  for (int i = 0; i < m_cohort->GetCount(); i++) {
+
+    cout << "DNA " << i + 1 << endl;
+
+    cout << "*********" << m_cohort->GetName(i) << "*********" << endl;
+
+    string sequence = m_cohort->Decode(i);
+
+    for (unsigned int j = 0; j < sequence.length(); j++){
+
+      cout << sequence[j] << "->";
+    }
+
+    cout << "END" << endl;
+  }
+
+  for (int i = 0; (m_mRNACohort != nullptr) && (i < m_mRNACohort->GetCount()); i++){
+
+    cout << "mRNA: " << i + 1 << endl;
+
+    cout << "*********" << m_mRNACohort->GetName(i) << "*********" << endl;
+
+    string sequence = m_mRNACohort->Decode(i);
+
+    for (unsigned int j = 0; j < sequence.length(); j++){
+
+      cout << sequence[j] << "->";
+    }
+
+    cout << "END" << endl;
+  }
+
+  return;
+}
+
     // Loop over each strand in the DNA vector
 
 for (unsigned int i = 0; i < m_DNA.size(); i++) {
@@ -112,9 +326,25 @@ for (unsigned int i = 0; i < m_DNA.size(); i++) {
         
         cout << "*********" << m_DNA.at(i)->GetName() << "*********" << endl;
 
+        // Reads from a FASTQ file also show their mean (binned) base quality
+
+        if (m_DNA.at(i)->HasQuality() && (m_DNA.at(i)->GetSize() > 0)) {
+
+          long long total = 0;
+
+          for (int j = 0; j < m_DNA.at(i)->GetSize(); j++){
+
+            total += m_DNA.at(i)->GetQuality(j);
+          }
+
+          cout << "Mean quality: Q" << total / m_DNA.at(i)->GetSize() << endl;
+        }
+
         // Print the DNA strand with arrows between each nucleotide
 
         cout  << *m_DNA.at(i) << endl;
+
+        EnforceBudget();
     }
 
 for (unsigned int i = 0; i < m_mRNA.size(); i++){
@@ -130,6 +360,8 @@ for (unsigned int i = 0; i < m_mRNA.size(); i++){
             cout << "*********" << m_mRNA.at(i)->GetName() << "*********" << endl;
 
             cout << *m_mRNA.at(i) << endl;
+
+            EnforceBudget();
         }
 
     }
@@ -146,489 +378,2295 @@ for (unsigned int i = 0; i < m_mRNA.size(); i++){
   // Postconditions: Populates each DNA strand and puts in m_DNA
 void Sequencer::ReadFile(){
 
+  const size_t CHUNK = 1 << 20; // bytes read from a plain file at a time
 
-  ifstream inputData;
+  string pending = ""; // start of a line that continues in the next chunk
 
-  inputData.open(m_fileName);
-  
-  if (inputData.is_open()){
+  string error = "";
 
-  // Declare variables to hold name and sequence
+  // Strands beyond the memory budget are spilled while the file is still loading
 
-  string name;
-  
-  string sequence; 
+  if((m_memoryBudget > 0) && !m_compress && (m_cache == nullptr)){
 
-  // Loop over the file, reading each name and sequence on a line 
+    m_cache = new StrandCache(m_memoryBudget);
+  }
 
-  while(getline(inputData, name,',') && getline(inputData, sequence)){
+  // Plain and compressed files both feed the same record parser chunk by chunk
 
-    //Create a new Strand object with the given name
+  // Readers see the strands of each chunk as soon as a snapshot is published
 
-    Strand *newStrand = new Strand(name);
+  bool started = false; // the format is decided by the first chunk
 
-    // Loop over the character in sequence, skipping commas and 
+  TextSink parser = [&](const char *data, size_t length){
 
-    for(int i = 0; i < sequence.length(); i++){
-        
-      if((sequence[i] != ',') && (sequence[i] != '\n')){
+    if(!started){
 
-        // Insert the current nucleotide into the Strand object
+      started = true;
 
-        newStrand -> InsertEnd(sequence[i]);
+      m_fastq = LooksLikeFastq(data, length);
+    }
 
-      }
+    ParseText(data, length, pending);
 
+    if(m_publish){
+
+      PublishSnapshot(m_DNA, false);
     }
+  };
 
-    // Add the completed Strand object to the m_DNA vector
+  // Only an uncompressed file can be read back at a record's offset
 
-    m_DNA.push_back(newStrand);
+  if(m_lazy && !m_compress && !GzipReader::IsCompressed(m_fileName) && !FileLooksLikeFastq(m_fileName)){
 
+    ReadIndex();
+
+    return;
   }
 
-  }else{
+  if(m_lazy){
 
-    cout << "Error reading file" << endl;
-    
+    cout << "Lazy loading needs an uncompressed file of one line records; reading every strand" << endl;
   }
 
-  //Close file once done reading
-
-  inputData.close();
+  if(GzipReader::IsCompressed(m_fileName)){
 
-}
+    if(!GzipReader::Read(m_fileName, m_threads, parser, error)){
 
+      cout << "Error reading file: " << error << endl;
+    }
 
+  }else{
 
-  // Name: MainMenu
-  // Desc: Displays the main menu and manages exiting.
-  //       Returns 5 if the user chooses to quit, else returns 0
-  // Preconditions: m_DNA populated
-  // Postconditions: Indicates the user has quit the program
-int Sequencer::MainMenu(){
+    ifstream inputData;
 
-  const int EXIT = 5;
+    inputData.open(m_fileName, ios::binary);
 
-  int choice = 0;  
+    if (inputData.is_open()){
 
-  // Displaying menu options
+      vector<char> buffer(CHUNK);
 
-  cout << "What would you like to do?: " <<  endl; 
+      while(inputData.read(buffer.data(), CHUNK) || (inputData.gcount() > 0)){
 
-  cout << "1. Display Stands\n" << endl;
+        parser(buffer.data(), inputData.gcount());
+      }
 
-  cout << "2. Reverse Strand\n" << endl;
+    }else{
 
-  cout << "3. Transcribe DNA to mRNA\n" << endl;
+      cout << "Error reading file" << endl;
 
-  cout << "4. Translate mRNA to Amino Acids\n" << endl;
+    }
 
-  cout << "5. Exit\n" << endl;
+    //Close file once done reading
 
-  //Reading user choice from input
+    inputData.close();
+  }
 
-  cin >> choice;
+  // The last record may not end with a line break
 
-    //Switch statement to determine which functions calls to make
+  if(!pending.empty()){
 
-    switch(choice){
-        case 1:
-        DisplayStrands();
-        break;
+    AddLine(pending.data(), pending.length());
+  }
 
-        case 2:
-        ReverseSequence();
-        break;
+  if(m_fastq){
 
-        case 3:
-        Transcribe();
-        break;
+    ReportFastq();
+  }
 
-        case 4:
-        Translate();
-        break;
+  if(m_dedup && (m_memoryBudget > 0)){
 
-        case 5:
-        break;
+    cout << "Duplicate collapsing is skipped under a memory budget (shared buffers cannot be evicted)\n" << endl;
 
-        default:
-        cout << "Invalid input. Please select something on the main menu" << endl;
+  }else if(m_dedup){
 
-    }
+    cout << "Collapsed " << m_duplicates << " duplicate strand(s) into shared buffers\n" << endl;
+  }
 
+  // Content hashes are only needed while records are being added
 
+  m_contents.clear();
 
-  // Return 0 if the user did not select exit from the menu options
+  // Compressed strands are published by the caller once they are decoded
 
-  if(choice == EXIT){
+  if(m_publish && !m_compress){
 
-    return EXIT;
+    PublishSnapshot(m_DNA, true);
+  }
 
-  }else{
+}
 
-    return 0;
 
-  }
-} 
+  // Name: ReadIndex
+  // Desc: Lazy version of ReadFile: loads or builds the record index and adds one
+  //       undecoded strand per record
+  // Preconditions: m_fileName is uncompressed
+  // Postconditions: m_DNA holds every record; bases are read when first used
+void Sequencer::ReadIndex(){
 
+  auto start = chrono::steady_clock::now();
 
-  // Name: ChooseDNA
-  // Desc: Asks the user to choose one strand to use from loaded DNA strands
-  // Preconditions: Populated m_DNA
-  // Postconditions: Returns index of chosen strand
-int Sequencer::ChooseDNA(){
+  RecordIndex index;
 
-  unsigned int choice = 0;
+  string error = "";
 
-  if(m_DNA.size() == 1){ // if there is only 1 strand
+  if(!index.Load(m_fileName, error)){
 
-    return 0;
+    cout << "Error reading file: " << error << endl;
 
-  }else{
+    return;
+  }
 
+  // Without a budget the cache only loads strands and never evicts them
 
-  do {
+  if(m_cache == nullptr){
 
-    cout << "Which strand would you like to work with?" << endl;
+    m_cache = new StrandCache(0);
+  }
 
-    cout << "Choose between: \n1 - " << m_DNA.size() << endl;
+  if(!m_cache->SetSource(m_fileName)){
 
-    cin >> choice;
-  
-  }while((choice < 1) || (choice > m_DNA.size()));
+    cout << "Error reading file" << endl;
 
+    return;
   }
 
-  return choice - 1; // Subtract - 1 Because a vector is 0 based
-
-  
-}
+  const vector<IndexEntry> &entries = index.GetEntries();
 
+  m_DNA.reserve(m_DNA.size() + entries.size());
 
-  // Name: ChooseMRNA
-  // Desc: Asks the user to choose one strand to use from translated mRNA strands
-  // Preconditions: Populated m_mRNA
-  // Postconditions: Returns index of chosen strand
-int Sequencer::ChooseMRNA(){
+  for(unsigned int i = 0; i < entries.size(); i++){
 
-  unsigned int choice = 0;
+    Strand *newStrand = new Strand(entries.at(i).m_name);
 
-  if(m_mRNA.size() == 1){ // if there is only 1 strand available
+    m_cache->AddLazy(newStrand, entries.at(i));
 
-    return 0;
+    m_dnaNames.emplace(entries.at(i).m_name, m_DNA.size());
 
-  }else{
+    m_DNA.push_back(newStrand);
+  }
 
+  if(m_dedup){
 
-  do {
+    cout << "Duplicate collapsing is skipped in lazy mode (bases are not read up front)" << endl;
+  }
 
-    cout << "Which strand would you like to work with?" << endl;
+  double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
 
-    cout << "Choose between: \n1 - " << m_mRNA.size() << endl;
+  cout << "Indexed " << entries.size() << " strand(s) in " << seconds << " s ("
+       << (index.WasBuilt() ? "wrote " : "used ") << m_fileName << ".idx)\n" << endl;
 
-    cin >> choice;
-  
-  }while((choice < 1) || (choice > m_mRNA.size()));
+  if(m_publish){
 
+    PublishSnapshot(m_DNA, true);
   }
 
-  return choice - 1; // - 1 Because a vector is 0 based
-
 }
 
+  // Name: ParseText
+  // Desc: Splits a chunk of file text into lines and passes each complete line to
+  //       AddLine. A line cut off at the end of the chunk is kept in pending.
+  // Preconditions: pending holds the unfinished line from the previous chunk
+  // Postconditions: Every complete line is added; pending holds the rest
+void Sequencer::ParseText(const char *data, size_t length, string &pending){
 
-  // Name: ReverseSequence
-  // Desc: User chooses to reverse either DNA or mRNA to reverse
-  //       Then calls either ChooseDNA or ChooseMRNA which returns index of strand
-  //       Calls ReverseStrand on chosen location
-  // Preconditions: Populated m_DNA or m_mRNA
-  // Postconditions: Reverses a specific strand replacing in place
-void Sequencer::ReverseSequence(){
-  //const for DNA choosing
+  const char *end = data + length;
 
-  const int DNA = 1;
-  const int mRNA = 2;
+  while(data < end){
 
-  // variables for choice and indexing vector
+    const char *lineEnd = (const char *)memchr(data, '\n', end - data);
 
-  int choice = 0;
-  int index = 0;
+    if(lineEnd == nullptr){
 
-do {
+      pending.append(data, end - data);
 
-  cout << "Which type of strand to reverse?\n1. DNA\n2. mRNA" << endl;
+      return;
+    }
 
-  cin >> choice;
+    if(pending.empty()){
 
-}while((choice != DNA && choice != mRNA));
+      AddLine(data, lineEnd - data);
 
-  if (choice == DNA){
+    }else{
 
-    index = ChooseDNA();
+      pending.append(data, lineEnd - data);
 
-    m_DNA.at(index)->ReverseStrand();
+      AddLine(pending.data(), pending.length());
 
-    cout << "Done reversing DNA " << index + 1 <<"'s. " <<endl;
+      pending.clear();
+    }
+
+    data = lineEnd + 1;
+  }
 
 }
 
-if(choice == mRNA){
 
-    if(m_mRNA.size() < 1){
+  // Name: AddLine
+  // Desc: Passes a line to AddFastqLine for FASTQ input, else to AddRecord
+  // Preconditions: line holds one line without its line break
+  // Postconditions: The line is handled by the parser of the input's format
+void Sequencer::AddLine(const char *line, size_t length){
 
-      cout << "No mRNA to reverse; transcribe first" << endl;
+  if(m_fastq){
 
-      return;
+    AddFastqLine(line, length);
 
-}else{
+  }else{
 
-    int index = 0;
+    AddRecord(line, length);
+  }
 
-    index = ChooseMRNA();
+}
 
-    m_mRNA.at(index)->ReverseStrand();
+  // Name: AddRecord
+  // Desc: Turns one line (name, then comma separated bases) into a DNA strand
+  //       or, when m_compress is set, a member of m_cohort
+  // Preconditions: line holds one record without its line break
+  // Postconditions: One strand is added (lines without a name are skipped)
+void Sequencer::AddRecord(const char *line, size_t length){
 
-    cout << "Done reversing mRNA " << index + 1 <<"'s. " <<endl;
+  const char *comma = (const char *)memchr(line, ',', length);
+
+  if(comma == nullptr){
+
+    return;
+  }
+
+  string name(line, comma - line);
+
+  // Collect the nucleotides of the record, skipping commas and carriage returns
+
+  string bases;
+
+  bases.reserve((length - name.length()) / 2 + 1);
+
+  for(const char *curr = comma + 1; curr < line + length; curr++){
+
+    if((*curr != ',') && (*curr != '\r')){
+
+      bases += *curr;
+    }
+  }
+
+  AddStrand(name, bases);
+
+}
+
+  // Name: AddStrand
+  // Desc: Adds the bases of one record as a DNA strand (sharing the buffer of an
+  //       identical earlier strand with m_dedup) or, when m_compress is set, as a
+  //       member of m_cohort
+  // Preconditions: bases holds only the record's nucleotides
+  // Postconditions: Returns the new strand, or nullptr for a cohort member
+Strand *Sequencer::AddStrand(const string &name, const string &bases){
+
+  if(m_compress){
+
+    // Compressed mode never builds a Strand; the record is
+    // encoded straight into the cohort
+
+    if(m_cohort == nullptr){
+
+      m_cohort = new StrandCohort();
+    }
+
+    m_cohort->AddStrand(name, bases);
+
+    m_dnaNames.emplace(name, m_cohort->GetCount() - 1);
+
+    return nullptr;
+  }
+
+  Strand *newStrand = nullptr;
+
+  // Shared buffers cannot be evicted, so a memory budget turns collapsing off
+
+  if(m_dedup && (m_memoryBudget == 0)){
+
+    // A record identical to an earlier one shares that strand's buffer;
+    // the bases are compared too, so a hash collision only costs the sharing
 
+    uint64_t hash = ContentHash(bases);
+
+    unordered_map<uint64_t, int>::iterator found = m_contents.find(hash);
+
+    if(found == m_contents.end()){
+
+      m_contents[hash] = m_DNA.size();
+
+    }else{
+
+      Strand *original = m_DNA.at(found->second);
+
+      const char *originalBases = original->GetBuffer();
+
+      if((originalBases != nullptr) && (original->GetSize() == int(bases.length())) &&
+         (memcmp(originalBases, bases.data(), bases.length()) == 0)){
+
+        newStrand = original->Share(name);
+
+        m_duplicates++;
+      }
     }
+  }
+
+  //Create a new Strand object with the given name and its bases
 
+  if(newStrand == nullptr){
+
+    newStrand = new Strand(name);
+
+    newStrand -> InsertEnd(bases);
   }
 
+  // Add the completed Strand object to the m_DNA vector
+
+  m_dnaNames.emplace(name, m_DNA.size());
+
+  m_DNA.push_back(newStrand);
+
+  CacheStrand(newStrand);
+
+  return newStrand;
+
 }
 
+  // Name: AddFastqLine
+  // Desc: Collects the four lines of a FASTQ record (@name, bases, +, qualities)
+  //       and passes the record through m_fastqFilter. Only reads that survive
+  //       trimming and filtering become strands, with their qualities binned.
+  // Preconditions: line holds one line without its line break
+  // Postconditions: A finished record is added or counted as dropped/malformed
+void Sequencer::AddFastqLine(const char *line, size_t length){
 
-  // Name: Transcribe
-  // Desc: Iterates through each DNA strand in m_DNA to transcribe to m_mRNA
-  // A->U, T->A, C->G, G->C (DNA to mRNA)
-  // Can be called multiple times (will result in multiple mRNA strands)
-  // Puts the transcribed mRNA strand into m_mRNA
-  // Note: if this function is called more than once on the same strands of DNA,
-  // it will add duplicate strands into m_mRNA!
-  // Preconditions: Populated m_DNA
-  // Postconditions: Transcribes each strand of m_DNA to m_mRNA
-void Sequencer::Transcribe(){
+  if((length > 0) && (line[length - 1] == '\r')){
+
+    length--;
+  }
 
-  //Declare and define const for nucleotides
+  // Blank lines between records are ignored
 
-  const char ADENINE = 'A';
-  const char GUANINE = 'G';
-  const char CYTOSINE = 'C';
-  const char THYMINE = 'T';
-  const char URACIL = 'U';
+  if((m_fastqLine == 0) && (length == 0)){
 
-  //initialize and define variables 
+    return;
+  }
 
-  int x = 0;
-  int y = 0;
-  int sequenceSize = 0;
+  switch(m_fastqLine){
 
-  //Loop through each DNA strand in the DNA vector
+    case 0: {
 
-while(x < m_DNA.size()){
+      if(line[0] != '@'){
 
-    //Create a new mRNA strand object with the same name as the current DNA strand
+        // Not a header: resynchronise on the next line starting with '@'
 
-    Strand *tRNA= new Strand(m_DNA.at(x)->GetName());
+        m_fastqFilter.CountMalformed();
 
-    //Get the size of the current DNA strand
+        return;
+      }
 
-    sequenceSize =  m_DNA.at(x)->GetSize();
+      // The read name is the first word of the header
 
-    //Loop through each nucleotide in the current DNA strand
-    
-    while(y < sequenceSize){
+      const char *end = line + 1;
+
+      while((end < line + length) && (*end != ' ') && (*end != '\t')){
+
+        end++;
+      }
+
+      m_fastqName.assign(line + 1, end - line - 1);
 
-      //Get the current nucleotide in the DNA strand
+      break;
+    }
+
+    case 1:
 
-      char newChar = m_DNA.at(x)->GetData(y);
+      m_fastqBases.assign(line, length);
 
-      //Replace each nucleotide in the DNA strand with its corresponding nucleotide in the mRNA strand
-      
-      if(newChar == ADENINE){
+      break;
 
-        tRNA -> InsertEnd(URACIL);
+    case 2:
 
-        //Increment the index of the current nucleotide in the DNA strand
+      if(line[0] != '+'){
 
-        y++;
+        m_fastqFilter.CountMalformed();
 
+        m_fastqLine = 0;
+
+        return;
       }
 
-      if(newChar == THYMINE){
+      break;
+
+    case 3: {
 
-        tRNA -> InsertEnd(ADENINE);
+      m_fastqLine = 0;
 
-        y++;
+      if(length != m_fastqBases.length()){
+
+        m_fastqFilter.CountMalformed();
+
+        return;
       }
 
-      if(newChar == CYTOSINE){
+      // Dropped reads stop here, before any strand is allocated
 
-        tRNA -> InsertEnd(GUANINE);
+      int keep = m_fastqFilter.Process(m_fastqBases.data(), line, length);
 
-        y++;
+      if(keep < 0){
+
+        return;
       }
 
-      if(newChar == GUANINE){
+      m_fastqBases.resize(keep);
+
+      Strand *newStrand = AddStrand(m_fastqName, m_fastqBases);
 
-        tRNA -> InsertEnd(CYTOSINE);
+      if(newStrand != nullptr){
 
-        y++;
+        vector<uint8_t> packed;
 
+        FastqFilter::PackQualities(line, keep, packed);
+
+        newStrand->SetQuality(move(packed));
       }
 
+      return;
     }
+  }
+
+  m_fastqLine++;
 
-    //Add the completed mRNA strand to the output vector
+}
 
-    m_mRNA.push_back(tRNA);
 
-    //Increment the index of thr current DNA strand
 
-    x++;
+  // Name: MainMenu
+  // Desc: Displays the main menu and manages exiting.
+  //       Returns 5 if the user chooses to quit (or input ends), else returns 0
+  // Preconditions: m_DNA populated
+  // Postconditions: Indicates the user has quit the program
+int Sequencer::MainMenu(){
 
-    //Reset the index of the current nucleotide in the DNA strand
+  const int EXIT = 5;
 
-    y = 0;
+  int choice = 0;  
 
-}
-  
-  cout << x  << " strand(s) of DNA successfully transcribed into new mRNA strands" << endl;
+  // Displaying menu options
 
-}
+  cout << "What would you like to do?: " <<  endl; 
 
+  cout << "1. Display Stands\n" << endl;
 
-  // Name: Translate
-  // Desc: Iterates through a chosen mRNA strand and converts to amino acids
-  // For every three nucleotides in strand, passes them three at a time to Convert
-  // Displays each amino acid but does not store the amino acids in the class
-  // Preconditions: Populated m_mRNA
-  // Postconditions: Translates a specific strand of mRNA to amino acids
-void Sequencer::Translate(){
+  cout << "2. Reverse Strand\n" << endl;
 
-  // initalize and declare variables 
+  cout << "3. Transcribe DNA to mRNA\n" << endl;
 
-  int choice = 0;
-  int strandSize = 0;
-  int c = 0; // iterator value of while loop
-  int count = 0; // Varaible to help keep track of the count for every three node
-  string codon = ""; //Variable to store the 3 chars as a string
+  cout << "4. Translate mRNA to Amino Acids\n" << endl;
 
+  cout << "5. Exit\n" << endl;
 
-  // Check if there are mRNA to translate
+  // Later actions go after Exit so scripted sessions keep their numbers
 
-  if(m_mRNA.size() < 1){
+  cout << "6. Extract a Region\n" << endl;
 
-    cout << "No mRNA to translate; transcribe first" << endl;
+  cout << "7. Search a Strand\n" << endl;
 
-    return;
+  cout << "8. Translate All mRNA to Proteins\n" << endl;
+
+  cout << "9. Save Proteins (FASTA)\n" << endl;
+
+  cout << "10. Edit a Strand\n" << endl;
 
+  //Reading user choice from input
+
+  cin >> choice;
+
+  // Only the end of input quits; anything that is not a number is dropped
+  // with the rest of its line and reported as invalid below
+
+  if(cin.eof()){
+
+    return EXIT;
   }
 
-  //choose which mRNA strand to translate
+  if(!cin){
 
-  choice = ChooseMRNA();
+    cin.clear();
 
-  //Get the size of the chose mRNA strand
+    cin.ignore(numeric_limits<streamsize>::max(), '\n');
 
-  strandSize = m_mRNA.at(choice)->GetSize();
-    
-    cout << "*********" << m_mRNA.at(choice)->GetName() << "*********" << endl;
+    choice = 0;
+  }
 
-while(c < int(strandSize)){
+    //Switch statement to determine which functions calls to make
 
-      // Variable to store character from each node
+    switch(choice){
+        case 1:
+        DisplayStrands();
+        break;
 
-      char Nucl = m_mRNA.at(choice)->GetData(c);
+        case 2:
+        ReverseSequence();
+        break;
 
-      //Add the nucleotides to the current codon
+        case 3:
+        Transcribe();
+        break;
 
-      codon+= Nucl;
+        case 4:
+        Translate();
+        break;
 
-      //increment counters
+        case 5:
+        break;
 
-      c++;
-      count++;
+        case 6:
+        ExtractRegion();
+        break;
 
-      if(count % 3 == 0){
+        case 7:
+        SearchStrand();
+        break;
 
-        //Utilize convert function
+        case 8:
+        TranslateAll();
+        break;
 
-        cout << codon << " -> " << Convert(codon) << endl;
+        case 9:
+        SaveProteins();
+        break;
 
-        //Reset it to an empty string
+        case 10:
+        EditStrand();
+        break;
 
-        codon = "";
+        default:
+        cout << "Invalid input. Please select something on the main menu" << endl;
 
-      }
+    }
+
+
+
+  // Return 0 if the user did not select exit from the menu options
+
+  if(choice == EXIT){
+
+    return EXIT;
+
+  }else{
+
+    return 0;
+
+  }
+} 
+
+
+  // Name: ChooseDNA
+  // Desc: Asks the user to choose one strand to use from loaded DNA strands
+  // Preconditions: Populated m_DNA
+  // Postconditions: Returns index of chosen strand
+int Sequencer::ChooseDNA(){
+
+  unsigned int choice = 0;
+
+  if(GetDNACount() == 1){ // if there is only 1 strand
+
+    return 0;
+
+  }else{
+
+
+  string input = "";
+
+  do {
+
+    cout << "Which strand would you like to work with?" << endl;
+
+    cout << "Choose between: \n1 - " << GetDNACount() << " (or enter a strand name)" << endl;
+
+    cin >> ws;
 
+    getline(cin, input);
+
+    // Out of input: fall back to the first strand; the caller checks cin
+
+    if(!cin){
+
+      return 0;
     }
 
-  cout << "Done translating mRNA " << choice + 1 << "'s strand."<< endl;
+    // Digits pick by position; anything else is looked up by name
+
+    if(input.find_first_not_of("0123456789") == string::npos){
+
+      choice = atoi(input.c_str());
+
+    }else{
+
+      choice = FindDNA(input) + 1;
+    }
+  
+  }while((choice < 1) || (choice > unsigned(GetDNACount())));
+
+  }
 
+  return choice - 1; // Subtract - 1 Because a vector is 0 based
+
+  
 }
 
 
+  // Name: ChooseMRNA
+  // Desc: Asks the user to choose one strand to use from translated mRNA strands
+  // Preconditions: Populated m_mRNA
+  // Postconditions: Returns index of chosen strand
+int Sequencer::ChooseMRNA(){
+
+  unsigned int choice = 0;
 
+  if(GetMRNACount() == 1){ // if there is only 1 strand available
 
-  // Name: Convert (Provided)
-  // Desc: Converts codon (three nodes) into an amino acid
-  // Preconditions: Passed exactly three U, A, G, or C
-  // Postconditions: Returns the string name of each amino acid
-string Sequencer::Convert(const string trinucleotide){
+    return 0;
+
+  }else{
+
+
+  string input = "";
+
+  do {
+
+    cout << "Which strand would you like to work with?" << endl;
+
+    cout << "Choose between: \n1 - " << GetMRNACount() << " (or enter a strand name)" << endl;
+
+    cin >> ws;
+
+    getline(cin, input);
+
+    // Out of input: fall back to the first strand; the caller checks cin
+
+    if(!cin){
 
-      if((trinucleotide=="AUU")||(trinucleotide=="AUC")||(trinucleotide=="AUA"))
-    return ("Isoleucine");
-  else if((trinucleotide=="CUU")||(trinucleotide=="CUC")||(trinucleotide=="CUA")||
-          (trinucleotide=="CUG")|| (trinucleotide=="UUA")||(trinucleotide=="UUG"))
-    return ("Leucine");
-  else if((trinucleotide=="GUU")||(trinucleotide=="GUC")||
-          (trinucleotide=="GUA")||(trinucleotide=="GUG"))
-    return ("Valine");
-  else if((trinucleotide=="UUU")||(trinucleotide=="UUC"))
-    return ("Phenylalanine");
-  else if((trinucleotide=="AUG"))
-    return ("Methionine (START)");
-  else if((trinucleotide=="UGU")||(trinucleotide=="UGC"))
-    return ("Cysteine");
-  else if((trinucleotide=="GCU")||(trinucleotide=="GCC")||
-          (trinucleotide=="GCA")||(trinucleotide=="GCG"))
-    return ("Alanine");
-  else if((trinucleotide=="GGU")||(trinucleotide=="GGC")||
-          (trinucleotide=="GGA")||(trinucleotide=="GGG"))
-    return ("Glycine");
-  else if((trinucleotide=="CCU")||(trinucleotide=="CCC")||
-          (trinucleotide=="CCA")||(trinucleotide=="CCG"))
-    return ("Proline");
-  else if((trinucleotide=="ACU")||(trinucleotide=="ACC")||
-          (trinucleotide=="ACA")||(trinucleotide=="ACG"))
-    return ("Threonine");
-  else if((trinucleotide=="UCU")||(trinucleotide=="UCC")||
-          (trinucleotide=="UCA")||(trinucleotide=="UCG")||
-          (trinucleotide=="AGU")||(trinucleotide=="AGC"))
-    return ("Serine");
-  else if((trinucleotide=="UAU")||(trinucleotide=="UAC"))
-    return ("Tyrosine");
-  else if((trinucleotide=="UGG"))
-    return ("Tryptophan");
-  else if((trinucleotide=="CAA")||(trinucleotide=="CAG"))
-    return ("Glutamine");
-  else if((trinucleotide=="AAU")||(trinucleotide=="AAC"))
-    return ("Asparagine");
-  else if((trinucleotide=="CAU")||(trinucleotide=="CAC"))
-    return ("Histidine");
-  else if((trinucleotide=="GAA")||(trinucleotide=="GAG"))
-    return ("Glutamic acid");
-  else if((trinucleotide=="GAU")||(trinucleotide=="GAC"))
-    return ("Aspartic acid");
-  else if((trinucleotide=="AAA")||(trinucleotide=="AAG"))
-    return ("Lysine");
-  else if((trinucleotide=="CGU")||(trinucleotide=="CGC")||(trinucleotide=="CGA")||
-          (trinucleotide=="CGG")||(trinucleotide=="AGA")||(trinucleotide=="AGG"))
-    return ("Arginine");
-  else if((trinucleotide=="UAA")||(trinucleotide=="UAG")||(trinucleotide=="UGA"))
-    return ("Stop");
-  else
-    cout << "returning unknown" << endl;
-  return ("Unknown");
-    }
\ No newline at end of file
+      return 0;
+    }
+
+    // Digits pick by position; anything else is looked up by name
+
+    if(input.find_first_not_of("0123456789") == string::npos){
+
+      choice = atoi(input.c_str());
+
+    }else{
+
+      choice = FindMRNA(input) + 1;
+    }
+  
+  }while((choice < 1) || (choice > unsigned(GetMRNACount())));
+
+  }
+
+  return choice - 1; // - 1 Because a vector is 0 based
+
+}
+
+
+  // Name: ReverseSequence
+  // Desc: User chooses to reverse either DNA or mRNA to reverse
+  //       Then calls either ChooseDNA or ChooseMRNA which returns index of strand
+  //       Calls ReverseStrand on chosen location
+  // Preconditions: Populated m_DNA or m_mRNA
+  // Postconditions: Reverses a specific strand replacing in place
+void Sequencer::ReverseSequence(){
+  //const for DNA choosing
+
+  const int DNA = 1;
+  const int mRNA = 2;
+
+  // variables for choice and indexing vector
+
+  int choice = 0;
+  int index = 0;
+
+if(m_cohort != nullptr){
+
+  // Reversing would break the alignment against the shared reference
+
+  cout << "Compressed strands cannot be reversed" << endl;
+
+  return;
+}
+
+do {
+
+  cout << "Which type of strand to reverse?\n1. DNA\n2. mRNA" << endl;
+
+  cin >> choice;
+
+}while((choice != DNA && choice != mRNA) && cin);
+
+if(!cin){
+
+  return;
+}
+
+  if (choice == DNA){
+
+    index = ChooseDNA();
+
+    if(!cin){
+
+      return;
+    }
+
+    m_DNA.at(index)->ReverseStrand();
+
+    cout << "Done reversing DNA " << index + 1 <<"'s. " <<endl;
+
+}
+
+if(choice == mRNA){
+
+    if(m_mRNA.size() < 1){
+
+      cout << "No mRNA to reverse; transcribe first" << endl;
+
+      return;
+
+}else{
+
+    int index = 0;
+
+    index = ChooseMRNA();
+
+    if(!cin){
+
+      return;
+    }
+
+    m_mRNA.at(index)->ReverseStrand();
+
+    cout << "Done reversing mRNA " << index + 1 <<"'s. " <<endl;
+
+    }
+
+  }
+
+}
+
+
+  // Name: ExtractRegion
+  // Desc: User chooses a DNA or mRNA strand and a [start, end) range
+  //       The range is added to the same vector as a new strand that shares
+  //       the original's bases (no copy is made)
+  // Preconditions: Populated m_DNA or m_mRNA
+  // Postconditions: A slice of the chosen strand is appended to its vector
+void Sequencer::ExtractRegion(){
+
+  const int DNA = 1;
+  const int mRNA = 2;
+
+  int choice = 0;
+  int start = 0;
+  int end = 0;
+
+  if(m_cohort != nullptr){
+
+    cout << "Regions cannot be extracted from compressed strands" << endl;
+
+    return;
+  }
+
+  do {
+
+    cout << "Which type of strand to extract from?\n1. DNA\n2. mRNA" << endl;
+
+    cin >> choice;
+
+  }while((choice != DNA && choice != mRNA) && cin);
+
+  if(!cin){
+
+    return;
+  }
+
+  if((choice == mRNA) && (m_mRNA.size() < 1)){
+
+    cout << "No mRNA to extract from; transcribe first" << endl;
+
+    return;
+  }
+
+  vector<Strand*> &strands = (choice == DNA) ? m_DNA : m_mRNA;
+
+  int index = (choice == DNA) ? ChooseDNA() : ChooseMRNA();
+
+  cout << "Enter the start and end positions (0 based, end not included)" << endl;
+
+  cin >> start >> end;
+
+  if(!cin){
+
+    return;
+  }
+
+  Strand *slice = strands.at(index)->Slice(start, end);
+
+  if(slice == nullptr){
+
+    cout << "Invalid range; the strand has " << strands.at(index)->GetSize() << " bases" << endl;
+
+    return;
+  }
+
+  (choice == DNA ? m_dnaNames : m_mRNANames).emplace(slice->GetName(), strands.size());
+
+  strands.push_back(slice);
+
+  CacheStrand(slice);
+
+  cout << "Added " << slice->GetName() << " as strand " << strands.size() << endl;
+
+}
+
+
+  // Name: EditStrand
+  // Desc: Asks for a DNA or mRNA strand and inserts, deletes or replaces bases at a
+  //       position. Edits go into the strand's piece table, so each one is O(log n).
+  // Preconditions: Populated m_DNA or m_mRNA
+  // Postconditions: The chosen strand is edited in place
+void Sequencer::EditStrand(){
+
+  const int DNA = 1;
+  const int mRNA = 2;
+  const int INSERT = 1;
+  const int DELETE = 2;
+  const int REPLACE = 3;
+
+  int choice = 0;
+  int edit = 0;
+  int pos = 0;
+  int length = 0;
+  string bases = "";
+  bool done = false;
+
+  if(m_cohort != nullptr){
+
+    cout << "Compressed strands cannot be edited" << endl;
+
+    return;
+  }
+
+  do {
+
+    cout << "Which type of strand to edit?\n1. DNA\n2. mRNA" << endl;
+
+    cin >> choice;
+
+  }while((choice != DNA && choice != mRNA) && cin);
+
+  if(!cin){
+
+    return;
+  }
+
+  if((choice == mRNA) && (m_mRNA.size() < 1)){
+
+    cout << "No mRNA to edit; transcribe first" << endl;
+
+    return;
+  }
+
+  Strand *strand = (choice == DNA) ? m_DNA.at(ChooseDNA()) : m_mRNA.at(ChooseMRNA());
+
+  do {
+
+    cout << "What edit?\n1. Insert bases\n2. Delete bases\n3. Replace bases" << endl;
+
+    cin >> edit;
+
+  }while(((edit < INSERT) || (edit > REPLACE)) && cin);
+
+  cout << "Enter the position (0 based)" << endl;
+
+  cin >> pos;
+
+  if(!cin){
+
+    return;
+  }
+
+  if(edit == DELETE){
+
+    cout << "How many bases to delete?" << endl;
+
+    cin >> length;
+
+    if(!cin){
+
+      return;
+    }
+
+    done = strand->Delete(pos, length);
+
+  }else{
+
+    cout << "Enter the bases" << endl;
+
+    cin >> bases;
+
+    if(!cin){
+
+      return;
+    }
+
+    // Only bases of the strand's own alphabet are accepted
+
+    const string valid = (choice == DNA) ? "ACGT" : "ACGU";
+
+    if(bases.find_first_not_of(valid) != string::npos){
+
+      cout << "Bases must be made of " << valid << endl;
+
+      return;
+    }
+
+    done = (edit == INSERT) ? strand->Insert(pos, bases) : strand->Replace(pos, bases);
+  }
+
+  if(!done){
+
+    cout << "Invalid position; the strand has " << strand->GetSize() << " bases" << endl;
+
+    return;
+  }
+
+  cout << strand->GetName() << " now has " << strand->GetSize() << " bases" << endl;
+
+}
+
+  // Name: SearchStrand
+  // Desc: User chooses a DNA or mRNA strand and a pattern of bases
+  //       Displays every position where the pattern occurs
+  // Preconditions: Populated m_DNA or m_mRNA
+  // Postconditions: Matches are displayed; nothing is changed
+void Sequencer::SearchStrand(){
+
+  const int DNA = 1;
+  const int mRNA = 2;
+
+  int choice = 0;
+  int found = 0;
+  string pattern = "";
+
+  if(m_cohort != nullptr){
+
+    cout << "Compressed strands cannot be searched" << endl;
+
+    return;
+  }
+
+  do {
+
+    cout << "Which type of strand to search?\n1. DNA\n2. mRNA" << endl;
+
+    cin >> choice;
+
+  }while((choice != DNA && choice != mRNA) && cin);
+
+  if(!cin){
+
+    return;
+  }
+
+  if((choice == mRNA) && (m_mRNA.size() < 1)){
+
+    cout << "No mRNA to search; transcribe first" << endl;
+
+    return;
+  }
+
+  Strand *strand = (choice == DNA) ? m_DNA.at(ChooseDNA()) : m_mRNA.at(ChooseMRNA());
+
+  cout << "Enter the bases to search for" << endl;
+
+  cin >> pattern;
+
+  if(!cin){
+
+    return;
+  }
+
+  // Report every (possibly overlapping) occurrence
+
+  for(int pos = strand->Find(pattern); pos != -1; pos = strand->Find(pattern, pos + 1)){
+
+    cout << pattern << " found at position " << pos << endl;
+
+    found++;
+  }
+
+  cout << found << " match(es) in " << strand->GetName() << endl;
+
+}
+
+
+  // Name: Transcribe
+  // Desc: Iterates through each DNA strand in m_DNA to transcribe to m_mRNA
+  // A->U, T->A, C->G, G->C (DNA to mRNA)
+  // Can be called multiple times (will result in multiple mRNA strands)
+  // Puts the transcribed mRNA strand into m_mRNA
+  // Note: if this function is called more than once on the same strands of DNA,
+  // it will add duplicate strands into m_mRNA!
+  // Strands holding anything other than A, T, C or G are reported and skipped
+  // Preconditions: Populated m_DNA
+  // Postconditions: Transcribes each strand of m_DNA to m_mRNA
+void Sequencer::Transcribe(){
+
+  //initialize and define variables 
+
+  int transcribed = 0;
+
+if(m_cohort != nullptr){
+
+  // The reference is transcribed once; members only complement their edits
+
+  if(m_mRNACohort == nullptr){
+
+    m_mRNACohort = new StrandCohort();
+  }
+
+  m_cohort->TranscribeInto(*m_mRNACohort);
+
+  cout << m_cohort->GetCount() << " strand(s) of DNA successfully transcribed into new mRNA strands" << endl;
+
+  return;
+}
+
+  size_t count = m_DNA.size();
+
+  vector<size_t> weights(count); // bases per strand, used to split the work by node
+
+  for(size_t i = 0; i < count; i++){
+
+    weights.at(i) = m_DNA.at(i)->GetSize();
+  }
+
+  // Collapsed duplicates share a buffer, so their mRNA can be shared as well.
+  // Only without a cache: an evicted buffer's address could be reused.
+
+  vector<int> sharedWith(count, -1);
+
+  if(m_dedup && (m_memoryBudget == 0)){
+
+    unordered_map<const char *, int> first;
+
+    for(size_t i = 0; i < count; i++){
+
+      if(weights.at(i) == 0){
+
+        continue;
+      }
+
+      auto found = first.emplace(m_DNA.at(i)->GetBuffer(), i);
+
+      if(!found.second && (weights.at(found.first->second) == weights.at(i))){
+
+        sharedWith.at(i) = found.first->second;
+      }
+    }
+  }
+
+  vector<Strand*> results(count, nullptr);
+
+  vector<int> statuses(count, CORE_OK);
+
+  vector<size_t> positions(count, 0); // where an invalid base was found
+
+  // Transcribes one strand; safe to run on several threads at once
+
+  auto transcribeOne = [&](size_t i){
+
+    if(sharedWith.at(i) >= 0){
+
+      return;
+    }
+
+    Strand *dna = m_DNA.at(i);
+
+    BaseSpan input = {dna->GetBuffer(), size_t(dna->GetSize())};
+
+    string bases(input.m_length, '\0');
+
+    OutputSpan output = {&bases[0], bases.size(), 0};
+
+    //Replace each nucleotide with its mRNA complement (A->U, T->A, C->G, G->C)
+
+    statuses.at(i) = CoreTranscribe(input, output);
+
+    if(statuses.at(i) == CORE_OK){
+
+      //Create a new mRNA strand object with the same name as the current DNA strand
+
+      results.at(i) = new Strand(dna->GetName());
+
+      results.at(i) -> InsertEnd(bases);
+
+    }else{
+
+      positions.at(i) = output.m_length;
+    }
+  };
+
+  // Adds one finished strand to m_mRNA, in DNA order
+
+  auto addResult = [&](size_t i){
+
+    int original = sharedWith.at(i);
+
+    if((original >= 0) && (results.at(original) != nullptr)){
+
+      results.at(i) = results.at(original)->Share(m_DNA.at(i)->GetName());
+
+    }else if(original >= 0){
+
+      statuses.at(i) = statuses.at(original);
+
+      positions.at(i) = positions.at(original);
+    }
+
+    Strand *tRNA = results.at(i);
+
+    if(tRNA != nullptr){
+
+      //Add the completed mRNA strand to the output vector
+
+      m_mRNANames.emplace(tRNA->GetName(), m_mRNA.size());
+
+      m_mRNA.push_back(tRNA);
+
+      CacheStrand(tRNA);
+
+      transcribed++;
+
+    }else{
+
+      cout << "Skipping DNA " << i + 1 << " (" << m_DNA.at(i)->GetName() << "): "
+           << CoreStatusMessage(statuses.at(i)) << " at position " << positions.at(i) << endl;
+    }
+  };
+
+  if(m_memoryBudget > 0){
+
+    // Under a memory budget strands are transcribed one at a time so the
+    // budget can be enforced after each
+
+    for(size_t i = 0; i < count; i++){
+
+      transcribeOne(i);
+
+      addResult(i);
+    }
+
+  }else{
+
+    auto start = chrono::steady_clock::now();
+
+    vector<NodeCounters> counters;
+
+    m_numa.ForEach(weights, m_threads, transcribeOne, counters);
+
+    for(size_t i = 0; i < count; i++){
+
+      addResult(i);
+    }
+
+    ReportNodes("Transcribe", counters, chrono::duration<double>(chrono::steady_clock::now() - start).count());
+  }
+  
+  cout << transcribed  << " strand(s) of DNA successfully transcribed into new mRNA strands" << endl;
+
+}
+
+
+  // Name: Translate
+  // Desc: Iterates through a chosen mRNA strand and converts to amino acids
+  // For every three nucleotides in strand, passes them three at a time to Convert
+  // Displays each amino acid but does not store the amino acids in the class
+  // Preconditions: Populated m_mRNA
+  // Postconditions: Translates a specific strand of mRNA to amino acids
+void Sequencer::Translate(){
+
+  // initalize and declare variables 
+
+  int choice = 0;
+  int strandSize = 0;
+  int c = 0; // iterator value of while loop
+  int count = 0; // Varaible to help keep track of the count for every three node
+  string codon = ""; //Variable to store the 3 chars as a string
+
+
+  // Check if there are mRNA to translate
+
+  if(GetMRNACount() < 1){
+
+    cout << "No mRNA to translate; transcribe first" << endl;
+
+    return;
+
+  }
+
+  //choose which mRNA strand to translate
+
+  choice = ChooseMRNA();
+
+  if(m_mRNACohort != nullptr){
+
+    // Codons untouched by this member's edits reuse the reference conversion
+
+    vector<string> codons;
+
+    vector<string> aminos;
+
+    int code = GetGeneticCode(m_mRNACohort->GetName(choice));
+
+    m_mRNACohort->Translate(choice, codons, aminos,
+                            [code](const string &codon){ return string(CoreResidueName(CoreCodonToResidue(codon.data(), code))); },
+                            code);
+
+    cout << "*********" << m_mRNACohort->GetName(choice) << "*********" << endl;
+
+    if(code != DEFAULT_GENETIC_CODE){
+
+      cout << "Using genetic code " << code << " (" << CoreGeneticCodeName(code) << ")" << endl;
+    }
+
+    for(unsigned int i = 0; i < codons.size(); i++){
+
+      cout << codons.at(i) << " -> " << aminos.at(i) << endl;
+    }
+
+    cout << "Done translating mRNA " << choice + 1 << "'s strand."<< endl;
+
+    return;
+  }
+
+  //Get the size of the chose mRNA strand
+
+  strandSize = m_mRNA.at(choice)->GetSize();
+    
+    cout << "*********" << m_mRNA.at(choice)->GetName() << "*********" << endl;
+
+  int code = GetGeneticCode(m_mRNA.at(choice)->GetName());
+
+  if(code != DEFAULT_GENETIC_CODE){
+
+    cout << "Using genetic code " << code << " (" << CoreGeneticCodeName(code) << ")" << endl;
+  }
+
+while(c < int(strandSize)){
+
+      // Variable to store character from each node
+
+      char Nucl = m_mRNA.at(choice)->GetData(c);
+
+      //Add the nucleotides to the current codon
+
+      codon+= Nucl;
+
+      //increment counters
+
+      c++;
+      count++;
+
+      if(count % 3 == 0){
+
+        //Utilize convert function
+
+        cout << codon << " -> " << CoreResidueName(CoreCodonToResidue(codon.data(), code)) << endl;
+
+        //Reset it to an empty string
+
+        codon = "";
+
+      }
+
+    }
+
+  cout << "Done translating mRNA " << choice + 1 << "'s strand."<< endl;
+
+}
+
+
+
+
+  // Name: TranslateAll
+  // Desc: Translates every mRNA strand into a Protein stored in m_protein
+  //       Replaces any proteins from an earlier batch translation
+  //       Displays the length and composition of each protein
+  // Preconditions: Populated m_mRNA
+  // Postconditions: m_protein holds one protein per mRNA strand
+void Sequencer::TranslateAll(){
+
+  if(GetMRNACount() < 1){
+
+    cout << "No mRNA to translate; transcribe first" << endl;
+
+    return;
+  }
+
+  for(unsigned int i = 0; i < m_protein.size(); i++){
+
+    delete m_protein.at(i);
+  }
+
+  m_protein.clear();
+
+  size_t count = GetMRNACount();
+
+  vector<size_t> weights(count); // bases per strand, used to split the work by node
+
+  for(size_t i = 0; i < count; i++){
+
+    weights.at(i) = (m_mRNACohort != nullptr) ? m_mRNACohort->GetSize(i) : m_mRNA.at(i)->GetSize();
+  }
+
+  vector<Protein*> results(count, nullptr);
+
+  // Translates one strand; safe to run on several threads at once
+
+  auto translateOne = [&](size_t i){
+
+    if(m_mRNACohort != nullptr){
+
+      string bases = m_mRNACohort->Decode(i);
+
+      results.at(i) = Protein::Translate(m_mRNACohort->GetName(i), i, bases.data(), bases.length(),
+                                         GetGeneticCode(m_mRNACohort->GetName(i)));
+
+    }else{
+
+      const char *bases = m_mRNA.at(i)->GetBuffer();
+
+      results.at(i) = Protein::Translate(m_mRNA.at(i)->GetName(), i, bases, m_mRNA.at(i)->GetSize(),
+                                         GetGeneticCode(m_mRNA.at(i)->GetName()));
+    }
+  };
+
+  auto addResult = [&](size_t i){
+
+    m_protein.push_back(results.at(i));
+
+    results.at(i)->WriteSummary(cout);
+  };
+
+  if(m_memoryBudget > 0){
+
+    // Under a memory budget strands are translated one at a time so the
+    // budget can be enforced after each
+
+    for(size_t i = 0; i < count; i++){
+
+      translateOne(i);
+
+      addResult(i);
+
+      EnforceBudget();
+    }
+
+  }else{
+
+    auto start = chrono::steady_clock::now();
+
+    vector<NodeCounters> counters;
+
+    m_numa.ForEach(weights, m_threads, translateOne, counters);
+
+    for(size_t i = 0; i < count; i++){
+
+      addResult(i);
+    }
+
+    ReportNodes("Translate", counters, chrono::duration<double>(chrono::steady_clock::now() - start).count());
+  }
+
+  cout << m_protein.size() << " mRNA strand(s) translated into proteins" << endl;
+
+}
+
+
+  // Name: SaveProteins
+  // Desc: Asks for a file name and writes every protein in m_protein as FASTA
+  // Preconditions: Populated m_protein
+  // Postconditions: Proteins are written to the chosen file
+void Sequencer::SaveProteins(){
+
+  string fileName = "";
+
+  if(m_protein.size() < 1){
+
+    cout << "No proteins to save; translate all mRNA first" << endl;
+
+    return;
+  }
+
+  cout << "Enter the file name to save the proteins to" << endl;
+
+  cin >> fileName;
+
+  if(!cin){
+
+    return;
+  }
+
+  ofstream outputData(fileName);
+
+  if(!outputData.is_open()){
+
+    cout << "Error opening " << fileName << endl;
+
+    return;
+  }
+
+  for(unsigned int i = 0; i < m_protein.size(); i++){
+
+    m_protein.at(i)->WriteFasta(outputData);
+  }
+
+  outputData.close();
+
+  cout << m_protein.size() << " protein(s) saved to " << fileName << endl;
+
+}
+
+
+  // Name: Convert (Provided)
+  // Desc: Converts codon (three nodes) into an amino acid
+  // Preconditions: Passed exactly three U, A, G, or C
+  // Postconditions: Returns the string name of each amino acid ("Unknown" if the
+  //                 codon is not valid; nothing is printed)
+string Sequencer::Convert(const string trinucleotide){
+
+  if(trinucleotide.length() != 3){
+
+    return ("Unknown");
+  }
+
+  // The lookup lives in the headless core and reports unknown codons by name
+
+  return CoreResidueName(CoreCodonToResidue(trinucleotide.data()));
+
+}
+
+  // Name: SetCompression
+  // Desc: Chooses whether ReadFile stores strands in a reference-based
+  //       StrandCohort instead of one Strand per record
+  // Preconditions: Called before StartSequencing
+  // Postconditions: m_compress is set
+void Sequencer::SetCompression(bool compress){
+
+  m_compress = compress;
+
+}
+
+  // Name: GetDNACount
+  // Preconditions: None
+  // Postconditions: Returns the number of loaded DNA strands (plain or compressed)
+int Sequencer::GetDNACount(){
+
+  if(m_cohort != nullptr){
+
+    return m_cohort->GetCount();
+  }
+
+  return m_DNA.size();
+
+}
+
+  // Name: GetMRNACount
+  // Preconditions: None
+  // Postconditions: Returns the number of mRNA strands (plain or compressed)
+int Sequencer::GetMRNACount(){
+
+  if(m_mRNACohort != nullptr){
+
+    return m_mRNACohort->GetCount();
+  }
+
+  return m_mRNA.size();
+
+}
+
+  // Name: ProfileCodons
+  // Desc: Reads the file and writes a codon usage matrix (64 codon counts and CAI
+  //       per strand, then corpus counts and RSCU) without showing the menu.
+  //       Uses m_mRNA if it has strands, otherwise the DNA strands as transcribed.
+  // Preconditions: m_fileName has been populated
+  // Postconditions: Matrix is written to outFile
+void Sequencer::ProfileCodons(string outFile){
+
+  ReadFile();
+
+  vector<Strand*> decoded; // compressed strands are decoded for profiling
+
+  bool isDNA = m_mRNA.empty();
+
+  vector<Strand*> &strands = (m_cohort != nullptr) ? decoded : (isDNA ? m_DNA : m_mRNA);
+
+  DecodeCohort(decoded);
+
+  ofstream outputData(outFile);
+
+  if(!outputData.is_open()){
+
+    cout << "Error opening " << outFile << endl;
+
+    return;
+  }
+
+  CodonProfile profile;
+
+  auto start = chrono::steady_clock::now();
+
+  profile.Profile(strands, isDNA, m_threads, [this](const string &name){ return GetGeneticCode(name); });
+
+  double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+  profile.WriteMatrix(outputData);
+
+  outputData.close();
+
+  const vector<string> &skipped = profile.GetSkipped();
+
+  for(unsigned int i = 0; i < skipped.size(); i++){
+
+    cout << "Skipping " << skipped.at(i) << ": its bases could not be loaded" << endl;
+  }
+
+  cout << strands.size() - skipped.size() << " strand(s) profiled (" << profile.GetBaseCount() << " bases in "
+       << seconds << " s on " << m_threads << " thread(s))" << endl;
+
+  for(unsigned int i = 0; i < decoded.size(); i++){
+
+    delete decoded.at(i);
+  }
+
+}
+
+  // Name: ClusterStrands
+  // Desc: Reads the file, sketches every strand with MinHash and writes the
+  //       strands' similarity clusters to outFile as a TSV
+  // Preconditions: m_fileName has been populated
+  // Postconditions: outFile holds one row per strand
+void Sequencer::ClusterStrands(string outFile){
+
+  ReadFile();
+
+  vector<Strand*> decoded; // compressed strands are decoded for sketching
+
+  DecodeCohort(decoded);
+
+  vector<Strand*> &strands = (m_cohort != nullptr) ? decoded : m_DNA;
+
+  ofstream outputData(outFile);
+
+  if(!outputData.is_open()){
+
+    cout << "Error opening " << outFile << endl;
+
+    return;
+  }
+
+  SketchCluster clusters(m_clusterANI);
+
+  auto start = chrono::steady_clock::now();
+
+  clusters.Build(strands, m_threads);
+
+  double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+  clusters.WriteClusters(outputData, strands);
+
+  outputData.close();
+
+  const vector<string> &skipped = clusters.GetSkipped();
+
+  for(unsigned int i = 0; i < skipped.size(); i++){
+
+    cout << "Skipping " << skipped.at(i) << ": its bases could not be loaded" << endl;
+  }
+
+  cout << strands.size() - skipped.size() << " strand(s) in " << clusters.GetClusterCount() << " cluster(s) at ANI >= "
+       << m_clusterANI << " (" << clusters.GetComparisons() << " sketch comparison(s) in "
+       << seconds << " s on " << m_threads << " thread(s))" << endl;
+
+  for(unsigned int i = 0; i < decoded.size(); i++){
+
+    delete decoded.at(i);
+  }
+
+}
+
+  // Name: SetClusterANI
+  // Desc: Sets the estimated ANI two strands need to share a cluster
+  // Preconditions: None
+  // Postconditions: Returns false (and keeps the current value) unless 0 < ani <= 1
+bool Sequencer::SetClusterANI(double ani){
+
+  if((ani <= 0.0) || (ani > 1.0)){
+
+    return false;
+  }
+
+  m_clusterANI = ani;
+
+  return true;
+
+}
+
+  // Name: SetThreads
+  // Desc: Sets how many threads parallel stages (decompression, profiling) use
+  // Preconditions: None
+  // Postconditions: m_threads is set (at least 1)
+void Sequencer::SetThreads(int threads){
+
+  m_threads = max(threads, 1);
+
+}
+
+  // Name: SetShards
+  // Desc: Sets the number of worker processes Shard forks and whether records are
+  //       split by byte range (default) or by a hash of the strand name
+  // Preconditions: None
+  // Postconditions: m_shards (at least 1) and m_shardByHash are set
+void Sequencer::SetShards(int shards, bool byHash){
+
+  m_shards = max(shards, 1);
+
+  m_shardByHash = byHash;
+
+}
+
+  // Name: Serve
+  // Desc: Reads the file once, then serves transcribe, translate, search and
+  //       stat requests over a Unix domain socket until interrupted
+  // Preconditions: m_fileName has been populated
+  // Postconditions: Server has shut down
+void Sequencer::Serve(string socketPath){
+
+  m_publish = true;
+
+  PublishSnapshot(m_DNA, false);
+
+  // Without a budget nothing is evicted under the readers, so the file can
+  // load in the background while requests are answered from snapshots
+
+  bool background = (m_memoryBudget == 0) && !m_compress;
+
+  thread loader;
+
+  if(background){
+
+    loader = thread(&Sequencer::ReadFile, this);
+
+  }else{
+
+    ReadFile();
+  }
+
+  vector<Strand*> decoded; // compressed strands are decoded for serving
+
+  DecodeCohort(decoded);
+
+  if(m_cohort != nullptr){
+
+    PublishSnapshot(decoded, true);
+  }
+
+  SequencerServer server([this](){ return GetSnapshot(); }, m_threads);
+
+  server.Run(socketPath);
+
+  if(loader.joinable()){
+
+    loader.join();
+  }
+
+  for(unsigned int i = 0; i < decoded.size(); i++){
+
+    delete decoded.at(i);
+  }
+
+}
+  // Name: Shard
+  // Desc: Transcribes and translates the file in m_shards worker processes and
+  //       writes every protein to outFile as FASTA, in input order. The parent
+  //       never loads the strands itself.
+  // Preconditions: m_fileName has been populated
+  // Postconditions: outFile holds the proteins, or an error has been displayed
+  //                 (FASTQ input is refused)
+void Sequencer::Shard(string outFile){
+
+  // Workers split the file at arbitrary bytes and parse CSV records only; FASTQ
+  // reads need the record framing and trimming that ReadFile gives them
+
+  if(FileLooksLikeFastq(m_fileName)){
+
+    cout << "Sharded run failed: " << m_fileName << " is FASTQ; --shard only reads strand files" << endl;
+
+    return;
+  }
+
+  // Workers inherit the genetic code settings through fork
+
+  ShardRunner runner(m_fileName, m_shards, m_shardByHash, max(m_threads / m_shards, 1),
+                     [this](const string &name){ return GetGeneticCode(name); });
+
+  string error = "";
+
+  auto start = chrono::steady_clock::now();
+
+  if(!runner.Run(outFile, error)){
+
+    cout << "Sharded run failed: " << error << endl;
+
+    return;
+  }
+
+  double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+  const vector<string> &skipped = runner.GetSkipped();
+
+  for(unsigned int i = 0; i < skipped.size(); i++){
+
+    cout << "Skipping DNA (" << skipped.at(i) << "): " << CoreStatusMessage(CORE_INVALID_BASE) << endl;
+  }
+
+  cout << runner.GetRecordCount() << " protein(s) saved to " << outFile << " ("
+       << m_shards << " shard(s) by " << (m_shardByHash ? "name hash" : "byte range")
+       << " in " << seconds << " s)" << endl;
+
+}
+
+  // Name: SetVariantFile
+  // Desc: Names a variant file whose SNPs and indels StartSequencing applies to the
+  //       loaded strands, adding each result as a new strand
+  // Preconditions: None
+  // Postconditions: m_variantFile is set
+void Sequencer::SetVariantFile(string fileName){
+
+  m_variantFile = fileName;
+
+}
+
+  // Name: SetCheckpointInterval
+  // Desc: Sets the minimum seconds between Batch checkpoints
+  // Preconditions: None
+  // Postconditions: m_checkpointSeconds is set (at least 0)
+void Sequencer::SetCheckpointInterval(int seconds){
+
+  m_checkpointSeconds = max(seconds, 0);
+
+}
+
+  // Name: ApplyVariants
+  // Desc: Applies the variants in m_variantFile to m_DNA in parallel and appends
+  //       one new strand per strand that had variants
+  // Preconditions: m_DNA populated
+  // Postconditions: m_DNA holds the new strands; skipped variants are reported
+void Sequencer::ApplyVariants(){
+
+  if(m_cohort != nullptr){
+
+    cout << "Variants cannot be applied to compressed strands" << endl;
+
+    return;
+  }
+
+  VariantEngine engine;
+
+  string error = "";
+
+  if(!engine.Read(m_variantFile, error)){
+
+    cout << "Error reading variants: " << error << endl;
+
+    return;
+  }
+
+  if(engine.GetMalformedCount() > 0){
+
+    cout << "Skipped " << engine.GetMalformedCount() << " malformed line(s) in " << m_variantFile << endl;
+  }
+
+  vector<string> unmatched = engine.GetUnmatchedNames(m_DNA);
+
+  for(unsigned int i = 0; i < unmatched.size(); i++){
+
+    cout << "No strand named " << unmatched.at(i) << " for its variants" << endl;
+  }
+
+  vector<VariantResult> results;
+
+  int applied = 0;
+
+  int strands = 0;
+
+  // Reports one strand's result and adds its new strand
+
+  auto addResult = [&](VariantResult &result){
+
+    if(result.m_strand == nullptr){
+
+      cout << "Skipping DNA " << result.m_source + 1 << " (" << m_DNA.at(result.m_source)->GetName()
+           << "): its bases could not be loaded" << endl;
+
+      return;
+    }
+
+    applied += result.m_applied;
+
+    strands++;
+
+    if(result.m_mismatched + result.m_overlapping > 0){
+
+      cout << "Strand " << result.m_source + 1 << " (" << m_DNA.at(result.m_source)->GetName() << "): skipped "
+           << result.m_mismatched << " ref mismatch(es) and " << result.m_overlapping
+           << " overlapping variant(s), first at line " << result.m_firstBadLine << endl;
+    }
+
+    m_dnaNames.emplace(result.m_strand->GetName(), m_DNA.size());
+
+    m_DNA.push_back(result.m_strand);
+
+    CacheStrand(result.m_strand);
+  };
+
+  auto start = chrono::steady_clock::now();
+
+  if(m_memoryBudget > 0){
+
+    // Under a memory budget strands are done one at a time so each new strand
+    // joins the cache (and the budget is enforced) before the next is built
+
+    size_t count = m_DNA.size();
+
+    for(size_t i = 0; i < count; i++){
+
+      const vector<Variant> *variants = engine.GetVariants(m_DNA.at(i)->GetName());
+
+      if(variants != nullptr){
+
+        VariantResult result = {nullptr, int(i), 0, 0, 0, 0};
+
+        VariantEngine::ApplyToStrand(m_DNA.at(i), *variants, result);
+
+        addResult(result);
+      }
+    }
+
+  }else{
+
+    engine.Apply(m_DNA, m_threads, results);
+
+    for(unsigned int i = 0; i < results.size(); i++){
+
+      addResult(results.at(i));
+    }
+  }
+
+  double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+  cout << "Applied " << applied << " of " << engine.GetVariantCount() << " variant(s) to "
+       << strands << " strand(s) in " << seconds << " s\n" << endl;
+
+}
+
+  // Name: Batch
+  // Desc: Streams the file through transcription and translation one record at a
+  //       time, appending proteins to outFile as FASTA. Progress is checkpointed
+  //       to outFile.ckpt and a rerun resumes from the last checkpoint.
+  // Preconditions: m_fileName has been populated
+  // Postconditions: outFile holds every protein, or an error has been displayed
+  //                 (FASTQ input is refused)
+void Sequencer::Batch(string outFile){
+
+  // Batch records are parsed as CSV strands; FASTQ reads would all be skipped
+
+  if(FileLooksLikeFastq(m_fileName)){
+
+    cout << "Batch run failed: " << m_fileName << " is FASTQ; --batch only reads strand files" << endl;
+
+    return;
+  }
+
+  BatchJob job(m_fileName, outFile, m_checkpointSeconds, m_threads,
+               [this](const string &name){ return GetGeneticCode(name); });
+
+  string error = "";
+
+  auto start = chrono::steady_clock::now();
+
+  bool done = job.Run(error);
+
+  double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+  if(job.GetResumedFrom() > 0){
+
+    cout << "Resumed after " << job.GetResumedFrom() << " record(s) from the last checkpoint" << endl;
+  }
+
+  if(!done){
+
+    cout << "Batch run failed: " << error << endl;
+
+    return;
+  }
+
+  const BatchCheckpoint &progress = job.GetProgress();
+
+  cout << progress.m_proteins << " protein(s) saved to " << outFile << " (" << progress.m_records
+       << " record(s), " << progress.m_skipped << " skipped, in " << seconds << " s)" << endl;
+
+}
+
+  // Name: SetMemoryBudget
+  // Desc: Limits the bytes of strand bases kept in memory; strands beyond the
+  //       budget are spilled to disk and paged back in when they are used
+  // Preconditions: Called before the file is read
+  // Postconditions: m_memoryBudget is set (0 keeps every strand resident)
+void Sequencer::SetMemoryBudget(size_t bytes){
+
+  m_memoryBudget = bytes;
+
+}
+
+  // Name: SetLazy
+  // Desc: Chooses whether ReadFile only indexes an uncompressed file (using or
+  //       writing a .idx sidecar) and decodes each strand the first time it is used
+  // Preconditions: Called before the file is read
+  // Postconditions: m_lazy is set
+void Sequencer::SetLazy(bool lazy){
+
+  m_lazy = lazy;
+
+}
+
+  // Name: SetDedup
+  // Desc: Chooses whether ReadFile collapses records with identical bases into
+  //       strands that share one buffer (found by a 64-bit content hash). Lazy
+  //       mode and a memory budget skip it.
+  // Preconditions: Called before the file is read
+  // Postconditions: m_dedup is set
+void Sequencer::SetDedup(bool dedup){
+
+  m_dedup = dedup;
+
+}
+
+  // Name: FindDNA
+  // Desc: Looks a DNA strand up by name in constant time
+  // Preconditions: None
+  // Postconditions: Returns the index of the first DNA strand called name, or -1
+int Sequencer::FindDNA(string name){
+
+  unordered_map<string, int>::iterator found = m_dnaNames.find(name);
+
+  return (found == m_dnaNames.end()) ? -1 : found->second;
+
+}
+
+  // Name: FindMRNA
+  // Desc: Looks an mRNA strand up by name in constant time
+  // Preconditions: None
+  // Postconditions: Returns the index of the first mRNA strand called name, or -1
+int Sequencer::FindMRNA(string name){
+
+  unordered_map<string, int>::iterator found = m_mRNANames.find(name);
+
+  return (found == m_mRNANames.end()) ? -1 : found->second;
+
+}
+
+  // Name: SetFastqSettings
+  // Desc: Sets how FASTQ reads are trimmed and filtered while the file is read
+  // Preconditions: Called before the file is read; 1 <= settings.m_window <= 128
+  // Postconditions: m_fastqFilter uses settings
+void Sequencer::SetFastqSettings(const FastqSettings &settings){
+
+  m_fastqFilter = FastqFilter(settings);
+
+}
+
+  // Name: ReportFastq
+  // Desc: Displays what trimming and filtering did to the FASTQ reads
+  // Preconditions: A FASTQ file was read
+  // Postconditions: The counts are displayed
+void Sequencer::ReportFastq(){
+
+  // A record cut off by the end of the file is malformed too
+
+  if(m_fastqLine != 0){
+
+    m_fastqFilter.CountMalformed();
+
+    m_fastqLine = 0;
+  }
+
+  const FastqStats &stats = m_fastqFilter.GetStats();
+
+  cout << "FASTQ: " << stats.m_kept << " of " << stats.m_reads << " read(s) kept ("
+       << stats.m_trimmed << " trimmed by " << stats.m_trimmedBases << " base(s)); dropped "
+       << stats.m_short << " short and " << stats.m_lowComplexity << " low complexity; "
+       << stats.m_malformed << " malformed record(s)\n" << endl;
+
+}
+
+  // Name: SetNuma
+  // Desc: Turns NUMA placement, partitioning and pinning of parallel stages on or off
+  // Preconditions: None
+  // Postconditions: Parallel stages treat the machine as one node when off
+void Sequencer::SetNuma(bool numa){
+
+  m_numa.SetEnabled(numa);
+
+}
+
+  // Name: PlaceStrands
+  // Desc: On a multi node machine, copies every strand's bases into memory first
+  //       touched by a worker pinned to the node that will process the strand
+  //       (parallel stages split m_DNA the same way)
+  // Preconditions: m_DNA populated
+  // Postconditions: Unshared strand buffers live on their node (no-op on one node,
+  //                 under a memory budget, for lazy strands or for compressed strands)
+void Sequencer::PlaceStrands(){
+
+  // Relocating a cached strand would page it in, which defeats lazy loading
+  // even when there is no memory budget
+
+  if((m_numa.GetNodeCount() < 2) || (m_memoryBudget > 0) || (m_cache != nullptr) || m_DNA.empty()){
+
+    return;
+  }
+
+  vector<size_t> weights(m_DNA.size());
+
+  for(unsigned int i = 0; i < m_DNA.size(); i++){
+
+    weights.at(i) = m_DNA.at(i)->GetSize();
+  }
+
+  auto start = chrono::steady_clock::now();
+
+  vector<NodeCounters> counters;
+
+  m_numa.ForEach(weights, m_threads, [this](size_t i){ m_DNA.at(i)->Relocate(); }, counters);
+
+  ReportNodes("Placement", counters, chrono::duration<double>(chrono::steady_clock::now() - start).count());
+
+}
+
+  // Name: ReportNodes
+  // Desc: Displays the per node counters of a NUMA partitioned stage
+  // Preconditions: counters came from NumaTopology::ForEach
+  // Postconditions: One line per node is displayed (nothing on a single node)
+void Sequencer::ReportNodes(string stage, const vector<NodeCounters> &counters, double seconds){
+
+  if(counters.size() < 2){
+
+    return;
+  }
+
+  cout << stage << " took " << seconds << " s on " << counters.size() << " NUMA node(s)" << endl;
+
+  for(unsigned int n = 0; n < counters.size(); n++){
+
+    const NodeCounters &node = counters.at(n);
+
+    double megabytes = node.m_bytes / 1e6;
+
+    cout << "  node " << m_numa.GetNodeId(n) << ": " << node.m_items << " strand(s) ("
+         << node.m_remoteItems << " from other nodes), " << megabytes << " MB, "
+         << ((node.m_busySeconds > 0) ? megabytes / node.m_busySeconds : 0) << " MB/s per worker" << endl;
+  }
+
+  cout << endl;
+
+}
+
+  // Name: GetSnapshot
+  // Desc: Returns the latest published snapshot of the DNA strands without a lock.
+  //       Snapshots are published while Serve loads the file.
+  // Preconditions: None
+  // Postconditions: Returns the snapshot, or nullptr if none was published
+shared_ptr<const StrandSnapshot> Sequencer::GetSnapshot(){
+
+  return atomic_load(&m_snapshot);
+
+}
+
+  // Name: PublishSnapshot
+  // Desc: Publishes strands as the new snapshot. While loading (complete false) it
+  //       is throttled so copying the strand list and name index costs at most
+  //       about a tenth of the loading time.
+  // Preconditions: m_publish is set; strands only grew since the last call
+  // Postconditions: GetSnapshot returns the new snapshot (unless it was throttled)
+void Sequencer::PublishSnapshot(const vector<Strand*> &strands, bool complete){
+
+  const chrono::milliseconds MIN_INTERVAL(20); // shortest gap between snapshots while loading
+
+  auto start = chrono::steady_clock::now();
+
+  if(!complete && (start < m_nextPublish)){
+
+    return;
+  }
+
+  // Only the strands added since the last snapshot need their code looked up
+
+  for(unsigned int i = m_snapshotCodes.size(); i < strands.size(); i++){
+
+    m_snapshotCodes.push_back(GetGeneticCode(strands.at(i)->GetName()));
+  }
+
+  shared_ptr<StrandSnapshot> snapshot = make_shared<StrandSnapshot>();
+
+  snapshot->m_strands = strands;
+
+  snapshot->m_codes = m_snapshotCodes;
+
+  snapshot->m_names = m_dnaNames;
+
+  snapshot->m_complete = complete;
+
+  // Readers still holding the old snapshot keep it alive until they let go
+
+  atomic_store(&m_snapshot, shared_ptr<const StrandSnapshot>(snapshot));
+
+  auto end = chrono::steady_clock::now();
+
+  m_nextPublish = end + max(chrono::duration_cast<chrono::steady_clock::duration>(MIN_INTERVAL), 9 * (end - start));
+
+}
+
+  // Name: CacheStrand
+  // Desc: Puts a new strand under the memory budget and enforces it
+  // Preconditions: strand was just added to m_DNA or m_mRNA
+  // Postconditions: strand may be evicted later (no-op without a budget)
+void Sequencer::CacheStrand(Strand *strand){
+
+  if(m_cache != nullptr){
+
+    m_cache->Add(strand);
+
+    m_cache->Enforce();
+  }
+
+}
+
+  // Name: EnforceBudget
+  // Desc: Evicts strands until the memory budget holds again
+  // Preconditions: No buffer returned by Strand::GetBuffer is still in use
+  // Postconditions: Resident strands fit the budget (no-op without a budget)
+void Sequencer::EnforceBudget(){
+
+  if(m_cache != nullptr){
+
+    m_cache->Enforce();
+  }
+
+}
+
+  // Name: ReportCache
+  // Desc: Displays the cache counters used to tune the memory budget
+  // Preconditions: None
+  // Postconditions: Counters are displayed (nothing without a budget or --lazy)
+void Sequencer::ReportCache(){
+
+  if(m_cache == nullptr){
+
+    return;
+  }
+
+  cout << "Strand cache: " << m_cache->GetResidentBytes() << " of ";
+
+  if(m_cache->GetBudget() > 0){
+
+    cout << m_cache->GetBudget();
+
+  }else{
+
+    cout << "unlimited";
+  }
+
+  cout << " bytes resident, " << m_cache->GetSpillBytes() << " bytes spilled, "
+       << m_cache->GetEvictions() << " eviction(s), " << m_cache->GetReloads() << " reload(s), "
+       << m_cache->GetLoads() << " lazy load(s)\n" << endl;
+
+}
+
+  // Name: DecodeCohort
+  // Desc: Rebuilds plain strands from m_cohort for stages that need strand buffers
+  // Preconditions: None
+  // Postconditions: strands gains one new strand per cohort member (caller deletes them)
+void Sequencer::DecodeCohort(vector<Strand*> &strands){
+
+  for(int i = 0; (m_cohort != nullptr) && (i < m_cohort->GetCount()); i++){
+
+    Strand *strand = new Strand(m_cohort->GetName(i));
+
+    strand->InsertEnd(m_cohort->Decode(i));
+
+    strands.push_back(strand);
+  }
+
+}
+
+  // Name: SetGeneticCode
+  // Desc: Sets the NCBI genetic code used to translate every strand
+  // Preconditions: None
+  // Postconditions: Returns false (and keeps the current code) if code is not valid
+bool Sequencer::SetGeneticCode(int code){
+
+  if(!CoreIsGeneticCode(code)){
+
+    return false;
+  }
+
+  m_geneticCode = code;
+
+  return true;
+
+}
+
+  // Name: SetStrandCode
+  // Desc: Translates the strand called name (DNA and its mRNA) with its own code
+  // Preconditions: None
+  // Postconditions: Returns false (and changes nothing) if code is not valid
+bool Sequencer::SetStrandCode(string name, int code){
+
+  if(!CoreIsGeneticCode(code)){
+
+    return false;
+  }
+
+  m_strandCodes[name] = code;
+
+  return true;
+
+}
+
+  // Name: GetGeneticCode
+  // Preconditions: None
+  // Postconditions: Returns the genetic code to translate the strand called name with
+int Sequencer::GetGeneticCode(string name){
+
+  map<string, int>::iterator found = m_strandCodes.find(name);
+
+  if(found != m_strandCodes.end()){
+
+    return found->second;
+  }
+
+  return m_geneticCode;
+
+}
@@ -9,12 +9,23 @@
 #define SEQUENCER_H
 
 #include "Strand.h"
+#include "StrandCohort.h"
+#include "Protein.h"
+#include "StrandCache.h"
+#include "StrandSnapshot.h"
+#include "NumaTopology.h"
+#include "FastqFilter.h"
 
 #include <fstream>
 #include <string>
 #include <iostream>
 #include <cstdlib>
 #include <vector>
+#include <map>
+#include <unordered_map>
+#include <cstdint>
+#include <memory>
+#include <chrono>
 using namespace std;
 
 class Sequencer {
@@ -46,7 +57,8 @@ class Sequencer {
   void DisplayStrands();
   // Name: ReadFile
   // Desc: Reads in a file of DNA strands that has the name on one line then
-  //       the sequence on the next
+  //       the sequence on the next. gzip and BGZF compressed files are detected
+  //       and decompressed in-process (BGZF blocks in parallel)
   //       All sequences will be an indeterminate length (always evenly divisible by three though).
   //       There are an indeterminate number of sequences in a file.
   //       Hint: Read in the entire sequence into a string then go char
@@ -56,7 +68,7 @@ class Sequencer {
   void ReadFile();
   // Name: MainMenu
   // Desc: Displays the main menu and manages exiting.
-  //       Returns 5 if the user chooses to quit, else returns 0
+  //       Returns 5 if the user chooses to quit (or input ends), else returns 0
   // Preconditions: m_DNA populated
   // Postconditions: Indicates the user has quit the program
   int MainMenu();
@@ -77,6 +89,25 @@ class Sequencer {
   // Preconditions: Populated m_DNA or m_mRNA
   // Postconditions: Reverses a specific strand replacing in place
   void ReverseSequence();
+  // Name: ExtractRegion
+  // Desc: User chooses a DNA or mRNA strand and a [start, end) range
+  //       The range is added to the same vector as a new strand that shares
+  //       the original's bases (no copy is made)
+  // Preconditions: Populated m_DNA or m_mRNA
+  // Postconditions: A slice of the chosen strand is appended to its vector
+  void ExtractRegion();
+  // Name: EditStrand
+  // Desc: Asks for a DNA or mRNA strand and inserts, deletes or replaces bases at a
+  //       position. Edits go into the strand's piece table, so each one is O(log n).
+  // Preconditions: Populated m_DNA or m_mRNA
+  // Postconditions: The chosen strand is edited in place
+  void EditStrand();
+  // Name: SearchStrand
+  // Desc: User chooses a DNA or mRNA strand and a pattern of bases
+  //       Displays every position where the pattern occurs
+  // Preconditions: Populated m_DNA or m_mRNA
+  // Postconditions: Matches are displayed; nothing is changed
+  void SearchStrand();
   // Name: Transcribe
   // Desc: Iterates through each DNA strand in m_DNA to transcribe to m_mRNA
   // A->U, T->A, C->G, G->C (DNA to mRNA)
@@ -84,6 +115,7 @@ class Sequencer {
   // Puts the transcribed mRNA strand into m_mRNA
   // Note: if this function is called more than once on the same strands of DNA,
   // it will add duplicate strands into m_mRNA!
+  // Strands holding anything other than A, T, C or G are reported and skipped
   // Preconditions: Populated m_DNA
   // Postconditions: Transcribes each strand of m_DNA to m_mRNA
   void Transcribe();
@@ -94,15 +126,282 @@ class Sequencer {
   // Preconditions: Populated m_mRNA
   // Postconditions: Translates a specific strand of mRNA to amino acids
   void Translate();
+  // Name: TranslateAll
+  // Desc: Translates every mRNA strand into a Protein stored in m_protein
+  //       Replaces any proteins from an earlier batch translation
+  //       Displays the length and composition of each protein
+  // Preconditions: Populated m_mRNA
+  // Postconditions: m_protein holds one protein per mRNA strand
+  void TranslateAll();
+  // Name: SaveProteins
+  // Desc: Asks for a file name and writes every protein in m_protein as FASTA
+  // Preconditions: Populated m_protein
+  // Postconditions: Proteins are written to the chosen file
+  void SaveProteins();
   // Name: Convert (Provided)
   // Desc: Converts codon (three nodes) into an amino acid
   // Preconditions: Passed exactly three U, A, G, or C
-  // Postconditions: Returns the string name of each amino acid
+  // Postconditions: Returns the string name of each amino acid ("Unknown" if the
+  //                 codon is not valid; nothing is printed)
   string Convert(const string);
+  // Name: ProfileCodons
+  // Desc: Reads the file and writes a codon usage matrix (64 codon counts and CAI
+  //       per strand, then corpus counts and RSCU) without showing the menu.
+  //       Uses m_mRNA if it has strands, otherwise the DNA strands as transcribed.
+  // Preconditions: m_fileName has been populated
+  // Postconditions: Matrix is written to outFile
+  void ProfileCodons(string outFile);
+  // Name: ClusterStrands
+  // Desc: Reads the file, sketches every strand with MinHash and writes the
+  //       strands' similarity clusters to outFile as a TSV
+  // Preconditions: m_fileName has been populated
+  // Postconditions: outFile holds one row per strand
+  void ClusterStrands(string outFile);
+  // Name: Serve
+  // Desc: Reads the file once, then serves transcribe, translate, search and
+  //       stat requests over a Unix domain socket until interrupted
+  // Preconditions: m_fileName has been populated
+  // Postconditions: Server has shut down
+  void Serve(string socketPath);
+  // Name: Shard
+  // Desc: Transcribes and translates the file in m_shards worker processes and
+  //       writes every protein to outFile as FASTA, in input order. The parent
+  //       never loads the strands itself.
+  // Preconditions: m_fileName has been populated
+  // Postconditions: outFile holds the proteins, or an error has been displayed
+  //                 (FASTQ input is refused)
+  void Shard(string outFile);
+  // Name: Batch
+  // Desc: Streams the file through transcription and translation one record at a
+  //       time, appending proteins to outFile as FASTA. Progress is checkpointed
+  //       to outFile.ckpt and a rerun resumes from the last checkpoint.
+  // Preconditions: m_fileName has been populated
+  // Postconditions: outFile holds every protein, or an error has been displayed
+  //                 (FASTQ input is refused)
+  void Batch(string outFile);
+  // Name: SetCompression
+  // Desc: Chooses whether ReadFile stores strands in a reference-based
+  //       StrandCohort instead of one Strand per record
+  // Preconditions: Called before StartSequencing
+  // Postconditions: m_compress is set
+  void SetCompression(bool compress);
+  // Name: SetGeneticCode
+  // Desc: Sets the NCBI genetic code used to translate every strand
+  // Preconditions: None
+  // Postconditions: Returns false (and keeps the current code) if code is not valid
+  bool SetGeneticCode(int code);
+  // Name: SetStrandCode
+  // Desc: Translates the strand called name (DNA and its mRNA) with its own code
+  // Preconditions: None
+  // Postconditions: Returns false (and changes nothing) if code is not valid
+  bool SetStrandCode(string name, int code);
+  // Name: SetThreads
+  // Desc: Sets how many threads parallel stages (decompression, profiling) use
+  // Preconditions: None
+  // Postconditions: m_threads is set (at least 1)
+  void SetThreads(int threads);
+  // Name: SetShards
+  // Desc: Sets the number of worker processes Shard forks and whether records are
+  //       split by byte range (default) or by a hash of the strand name
+  // Preconditions: None
+  // Postconditions: m_shards (at least 1) and m_shardByHash are set
+  void SetShards(int shards, bool byHash);
+  // Name: SetVariantFile
+  // Desc: Names a variant file whose SNPs and indels StartSequencing applies to the
+  //       loaded strands, adding each result as a new strand
+  // Preconditions: None
+  // Postconditions: m_variantFile is set
+  void SetVariantFile(string fileName);
+  // Name: SetCheckpointInterval
+  // Desc: Sets the minimum seconds between Batch checkpoints
+  // Preconditions: None
+  // Postconditions: m_checkpointSeconds is set (at least 0)
+  void SetCheckpointInterval(int seconds);
+  // Name: SetMemoryBudget
+  // Desc: Limits the bytes of strand bases kept in memory; strands beyond the
+  //       budget are spilled to disk and paged back in when they are used
+  // Preconditions: Called before the file is read
+  // Postconditions: m_memoryBudget is set (0 keeps every strand resident)
+  void SetMemoryBudget(size_t bytes);
+  // Name: SetLazy
+  // Desc: Chooses whether ReadFile only indexes an uncompressed file (using or
+  //       writing a .idx sidecar) and decodes each strand the first time it is used
+  // Preconditions: Called before the file is read
+  // Postconditions: m_lazy is set
+  void SetLazy(bool lazy);
+  // Name: SetDedup
+  // Desc: Chooses whether ReadFile collapses records with identical bases into
+  //       strands that share one buffer (found by a 64-bit content hash). Lazy
+  //       mode and a memory budget skip it.
+  // Preconditions: Called before the file is read
+  // Postconditions: m_dedup is set
+  void SetDedup(bool dedup);
+  // Name: FindDNA
+  // Desc: Looks a DNA strand up by name in constant time
+  // Preconditions: None
+  // Postconditions: Returns the index of the first DNA strand called name, or -1
+  int FindDNA(string name);
+  // Name: FindMRNA
+  // Desc: Looks an mRNA strand up by name in constant time
+  // Preconditions: None
+  // Postconditions: Returns the index of the first mRNA strand called name, or -1
+  int FindMRNA(string name);
+  // Name: SetFastqSettings
+  // Desc: Sets how FASTQ reads are trimmed and filtered while the file is read
+  // Preconditions: Called before the file is read; 1 <= settings.m_window <= 128
+  // Postconditions: m_fastqFilter uses settings
+  void SetFastqSettings(const FastqSettings &settings);
+  // Name: SetNuma
+  // Desc: Turns NUMA placement, partitioning and pinning of parallel stages on or off
+  // Preconditions: None
+  // Postconditions: Parallel stages treat the machine as one node when off
+  void SetNuma(bool numa);
+  // Name: GetSnapshot
+  // Desc: Returns the latest published snapshot of the DNA strands without a lock.
+  //       Snapshots are published while Serve loads the file.
+  // Preconditions: None
+  // Postconditions: Returns the snapshot, or nullptr if none was published
+  shared_ptr<const StrandSnapshot> GetSnapshot();
+  // Name: SetClusterANI
+  // Desc: Sets the estimated ANI two strands need to share a cluster
+  // Preconditions: None
+  // Postconditions: Returns false (and keeps the current value) unless 0 < ani <= 1
+  bool SetClusterANI(double ani);
 private:
+  // Name: ParseText
+  // Desc: Splits a chunk of file text into lines and passes each complete line to
+  //       AddRecord. A line cut off at the end of the chunk is kept in pending.
+  // Preconditions: pending holds the unfinished line from the previous chunk
+  // Postconditions: Every complete line is added; pending holds the rest
+  void ParseText(const char *data, size_t length, string &pending);
+  // Name: AddLine
+  // Desc: Passes a line to AddFastqLine for FASTQ input, else to AddRecord
+  // Preconditions: line holds one line without its line break
+  // Postconditions: The line is handled by the parser of the input's format
+  void AddLine(const char *line, size_t length);
+  // Name: AddRecord
+  // Desc: Turns one line (name, then comma separated bases) into a DNA strand
+  //       or, when m_compress is set, a member of m_cohort
+  // Preconditions: line holds one record without its line break
+  // Postconditions: One strand is added (lines without a name are skipped)
+  void AddRecord(const char *line, size_t length);
+  // Name: AddStrand
+  // Desc: Adds the bases of one record as a DNA strand (sharing the buffer of an
+  //       identical earlier strand with m_dedup) or, when m_compress is set, as a
+  //       member of m_cohort
+  // Preconditions: bases holds only the record's nucleotides
+  // Postconditions: Returns the new strand, or nullptr for a cohort member
+  Strand *AddStrand(const string &name, const string &bases);
+  // Name: AddFastqLine
+  // Desc: Collects the four lines of a FASTQ record (@name, bases, +, qualities)
+  //       and passes the record through m_fastqFilter. Only reads that survive
+  //       trimming and filtering become strands, with their qualities binned.
+  // Preconditions: line holds one line without its line break
+  // Postconditions: A finished record is added or counted as dropped/malformed
+  void AddFastqLine(const char *line, size_t length);
+  // Name: ReportFastq
+  // Desc: Displays what trimming and filtering did to the FASTQ reads
+  // Preconditions: A FASTQ file was read
+  // Postconditions: The counts are displayed
+  void ReportFastq();
+  // Name: PlaceStrands
+  // Desc: On a multi node machine, copies every strand's bases into memory first
+  //       touched by a worker pinned to the node that will process the strand
+  //       (parallel stages split m_DNA the same way)
+  // Preconditions: m_DNA populated
+  // Postconditions: Unshared strand buffers live on their node (no-op on one node,
+  //                 under a memory budget, for lazy strands or for compressed strands)
+  void PlaceStrands();
+  // Name: ReportNodes
+  // Desc: Displays the per node counters of a NUMA partitioned stage
+  // Preconditions: counters came from NumaTopology::ForEach
+  // Postconditions: One line per node is displayed (nothing on a single node)
+  void ReportNodes(string stage, const vector<NodeCounters> &counters, double seconds);
+  // Name: PublishSnapshot
+  // Desc: Publishes strands as the new snapshot. While loading (complete false) it
+  //       is throttled so copying the strand list and name index costs at most
+  //       about a tenth of the loading time.
+  // Preconditions: m_publish is set; strands only grew since the last call
+  // Postconditions: GetSnapshot returns the new snapshot (unless it was throttled)
+  void PublishSnapshot(const vector<Strand*> &strands, bool complete);
+  // Name: ReadIndex
+  // Desc: Lazy version of ReadFile: loads or builds the record index and adds one
+  //       undecoded strand per record
+  // Preconditions: m_fileName is uncompressed
+  // Postconditions: m_DNA holds every record; bases are read when first used
+  void ReadIndex();
+  // Name: ApplyVariants
+  // Desc: Applies the variants in m_variantFile to m_DNA in parallel and appends
+  //       one new strand per strand that had variants
+  // Preconditions: m_DNA populated
+  // Postconditions: m_DNA holds the new strands; skipped variants are reported
+  void ApplyVariants();
+  // Name: CacheStrand
+  // Desc: Puts a new strand under the memory budget and enforces it
+  // Preconditions: strand was just added to m_DNA or m_mRNA
+  // Postconditions: strand may be evicted later (no-op without a budget)
+  void CacheStrand(Strand *strand);
+  // Name: EnforceBudget
+  // Desc: Evicts strands until the memory budget holds again
+  // Preconditions: No buffer returned by Strand::GetBuffer is still in use
+  // Postconditions: Resident strands fit the budget (no-op without a budget)
+  void EnforceBudget();
+  // Name: ReportCache
+  // Desc: Displays the cache counters used to tune the memory budget
+  // Preconditions: None
+  // Postconditions: Counters are displayed (nothing without a budget or --lazy)
+  void ReportCache();
+  // Name: DecodeCohort
+  // Desc: Rebuilds plain strands from m_cohort for stages that need strand buffers
+  // Preconditions: None
+  // Postconditions: strands gains one new strand per cohort member (caller deletes them)
+  void DecodeCohort(vector<Strand*> &strands);
+  // Name: GetGeneticCode
+  // Preconditions: None
+  // Postconditions: Returns the genetic code to translate the strand called name with
+  int GetGeneticCode(string name);
+  // Name: GetDNACount
+  // Preconditions: None
+  // Postconditions: Returns the number of loaded DNA strands (plain or compressed)
+  int GetDNACount();
+  // Name: GetMRNACount
+  // Preconditions: None
+  // Postconditions: Returns the number of mRNA strands (plain or compressed)
+  int GetMRNACount();
   vector<Strand*> m_DNA; //Stores all DNA strands
   vector<Strand*> m_mRNA; //Stores all mRNA strands
+  vector<Protein*> m_protein; //Stores all translated proteins
   string m_fileName; //File to read in
+  bool m_compress; //Store strands delta-encoded against a reference
+  int m_threads; //Threads used by parallel stages
+  NumaTopology m_numa; //Nodes that parallel stages partition their work over
+  int m_shards; //Worker processes used by Shard
+  bool m_shardByHash; //Shard by strand name hash instead of byte range
+  string m_variantFile; //Variants applied after loading, or empty
+  int m_checkpointSeconds; //Minimum seconds between Batch checkpoints
+  size_t m_memoryBudget; //Bytes of bases kept in memory, 0 for no limit
+  bool m_lazy; //Index the file and decode strands on first use
+  StrandCache *m_cache; //Spills strands beyond m_memoryBudget and loads lazy strands
+                        //(nullptr without a budget or m_lazy)
+  double m_clusterANI; //ANI threshold used by ClusterStrands
+  int m_geneticCode; //NCBI genetic code used for translation
+  map<string, int> m_strandCodes; //Per strand genetic codes that override m_geneticCode
+  unordered_map<string, int> m_dnaNames; //Name -> index of the first DNA strand with it
+  unordered_map<string, int> m_mRNANames; //Name -> index of the first mRNA strand with it
+  bool m_dedup; //Share one buffer between records with identical bases
+  unordered_map<uint64_t, int> m_contents; //Content hash -> first DNA strand with it (while loading)
+  int m_duplicates; //Records that were collapsed onto an earlier strand
+  bool m_publish; //Publish snapshots while loading (set by Serve)
+  bool m_fastq; //The input is FASTQ (decided from its first chunk)
+  FastqFilter m_fastqFilter; //Trims and filters FASTQ reads as they are read
+  int m_fastqLine; //Line of the current FASTQ record (0 header ... 3 qualities)
+  string m_fastqName; //Name of the current FASTQ record
+  string m_fastqBases; //Bases of the current FASTQ record
+  shared_ptr<const StrandSnapshot> m_snapshot; //Latest snapshot (atomic_load/atomic_store only)
+  vector<int> m_snapshotCodes; //Genetic codes of the strands published so far
+  chrono::steady_clock::time_point m_nextPublish; //Earliest time of the next throttled publish
+  StrandCohort *m_cohort; //Compressed DNA strands (when m_compress)
+  StrandCohort *m_mRNACohort; //Compressed mRNA strands (when m_compress)
 };
 
 #endif
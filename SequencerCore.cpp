@@ -0,0 +1,303 @@
+// File:    SequencerCore.cpp
+// Author:  Hazael Magino
+// Date:    10/19/2026
+// Section: Section 12
+// E-mail:  hazaelm1@umbc.edu
+// Description: Headless compute core of the sequencer. Every call works on spans of
+// bases, writes into buffers the caller owns and returns a status code; nothing here
+// prints, prompts or allocates.
+
+#include <cstring>
+#include "SequencerCore.h"
+#include "TranslateKernel.h"
+
+// Expands F(ID) once for every NCBI genetic code so each gets its own instantiation
+#define FOR_EACH_GENETIC_CODE(F) \
+  F(1) F(2) F(3) F(4) F(5) F(6) F(9) F(10) F(11) F(12) F(13) F(14) F(15) F(16) \
+  F(21) F(22) F(23) F(24) F(25) F(26) F(27) F(28) F(29) F(30) F(31) F(33)
+
+// Lookup tables built once: DNA->mRNA complement and base->2 bit codon digit (4 if invalid)
+struct CoreTables {
+  char m_complement[256];
+  unsigned char m_digit[256];
+  CoreTables(){
+    memset(m_complement, 0, sizeof(m_complement));
+    memset(m_digit, 4, sizeof(m_digit));
+    m_complement[(unsigned char)'A'] = 'U';
+    m_complement[(unsigned char)'T'] = 'A';
+    m_complement[(unsigned char)'C'] = 'G';
+    m_complement[(unsigned char)'G'] = 'C';
+    m_digit[(unsigned char)'U'] = 0; m_digit[(unsigned char)'T'] = 0;
+    m_digit[(unsigned char)'C'] = 1; m_digit[(unsigned char)'A'] = 2;
+    m_digit[(unsigned char)'G'] = 3;
+  }
+};
+
+static const CoreTables TABLES;
+
+  // Name: CoreTranscribe
+  // Desc: Transcribes DNA to mRNA (A->U, T->A, C->G, G->C)
+  // Preconditions: output.m_capacity >= dna.m_length
+  // Postconditions: Returns CORE_OK and output holds the mRNA, or an error code;
+  //                 on CORE_INVALID_BASE output.m_length is the offset of the bad base
+int CoreTranscribe(BaseSpan dna, OutputSpan &output){
+
+  output.m_length = 0;
+
+  if(((dna.m_data == nullptr) || (output.m_data == nullptr)) && (dna.m_length > 0)){
+
+    return CORE_BAD_ARGUMENT;
+  }
+
+  if(output.m_capacity < dna.m_length){
+
+    return CORE_BUFFER_TOO_SMALL;
+  }
+
+  for(size_t i = 0; i < dna.m_length; i++){
+
+    char base = TABLES.m_complement[(unsigned char)dna.m_data[i]];
+
+    if(base == 0){
+
+      output.m_length = i;
+
+      return CORE_INVALID_BASE;
+    }
+
+    output.m_data[i] = base;
+  }
+
+  output.m_length = dna.m_length;
+
+  return CORE_OK;
+
+}
+
+  // Name: TranslateWith
+  // Desc: Translation for one genetic code. The table is a compile-time constant of
+  //       the instantiation and is handed to the bulk kernel (SIMD when the CPU
+  //       has it), so the per-codon loop never looks at the code.
+  // Preconditions: output has room for mRNA.m_length / 3 residues
+  // Postconditions: Returns CORE_OK, or CORE_INVALID_BASE with 'X' for bad codons
+template<int ID>
+static int TranslateWith(BaseSpan mRNA, OutputSpan &output){
+
+  static constexpr array<char, 64> TABLE = GeneticCode<ID>::TABLE;
+
+  size_t codons = mRNA.m_length / 3;
+
+  bool valid = TranslateCodons(mRNA.m_data, codons, TABLE.data(), output.m_data);
+
+  output.m_length = codons;
+
+  return valid ? CORE_OK : CORE_INVALID_BASE;
+
+}
+
+int CoreTranslate(BaseSpan mRNA, OutputSpan &output, int code){
+
+  output.m_length = 0;
+
+  size_t codons = mRNA.m_length / 3;
+
+  if(((mRNA.m_data == nullptr) || (output.m_data == nullptr)) && (codons > 0)){
+
+    return CORE_BAD_ARGUMENT;
+  }
+
+  if(output.m_capacity < codons){
+
+    return CORE_BUFFER_TOO_SMALL;
+  }
+
+  switch(code){
+
+#define TRANSLATE_CASE(ID) case ID: return TranslateWith<ID>(mRNA, output);
+    FOR_EACH_GENETIC_CODE(TRANSLATE_CASE)
+#undef TRANSLATE_CASE
+
+    default:
+      return CORE_UNKNOWN_CODE;
+  }
+
+}
+
+  // Name: CoreTranscribeBatch
+  // Desc: Transcribes count sequences into count caller-provided buffers
+  // Preconditions: inputs and outputs have count entries
+  // Postconditions: Returns CORE_OK, or the first error with *failed set to its
+  //                 index (the other sequences are still processed)
+int CoreTranscribeBatch(const BaseSpan *inputs, OutputSpan *outputs, size_t count, size_t *failed){
+
+  if(((inputs == nullptr) || (outputs == nullptr)) && (count > 0)){
+
+    return CORE_BAD_ARGUMENT;
+  }
+
+  int first = CORE_OK;
+
+  for(size_t i = 0; i < count; i++){
+
+    int status = CoreTranscribe(inputs[i], outputs[i]);
+
+    if((status != CORE_OK) && (first == CORE_OK)){
+
+      first = status;
+
+      if(failed != nullptr){
+
+        *failed = i;
+      }
+    }
+  }
+
+  return first;
+
+}
+
+  // Name: CoreTranslateBatch
+  // Desc: Translates count mRNA sequences into count caller-provided buffers
+  // Preconditions: inputs and outputs have count entries
+  // Postconditions: Returns CORE_OK, or the first error with *failed set to its
+  //                 index (the other sequences are still processed)
+int CoreTranslateBatch(const BaseSpan *inputs, OutputSpan *outputs, size_t count, size_t *failed,
+                       int code){
+
+  if(((inputs == nullptr) || (outputs == nullptr)) && (count > 0)){
+
+    return CORE_BAD_ARGUMENT;
+  }
+
+  int first = CORE_OK;
+
+  for(size_t i = 0; i < count; i++){
+
+    int status = CoreTranslate(inputs[i], outputs[i], code);
+
+    if((status != CORE_OK) && (first == CORE_OK)){
+
+      first = status;
+
+      if(failed != nullptr){
+
+        *failed = i;
+      }
+    }
+  }
+
+  return first;
+
+}
+
+  // Name: CoreCodonToResidue
+  // Desc: Looks up the one-letter code of one codon in NCBI genetic code `code`
+  // Preconditions: codon points at three chars
+  // Postconditions: Returns the residue, '*' for Stop or 'X' if a base or the code is invalid
+char CoreCodonToResidue(const char *codon, int code){
+
+  unsigned int first = TABLES.m_digit[(unsigned char)codon[0]];
+  unsigned int second = TABLES.m_digit[(unsigned char)codon[1]];
+  unsigned int third = TABLES.m_digit[(unsigned char)codon[2]];
+
+  if((first | second | third) & 4){
+
+    return 'X';
+  }
+
+  unsigned int index = (first << 4) | (second << 2) | third;
+
+  switch(code){
+
+#define RESIDUE_CASE(ID) case ID: return GeneticCode<ID>::TABLE[index];
+    FOR_EACH_GENETIC_CODE(RESIDUE_CASE)
+#undef RESIDUE_CASE
+
+    default:
+      return 'X';
+  }
+
+}
+
+  // Name: CoreIsGeneticCode
+  // Preconditions: None
+  // Postconditions: Returns true if code is an NCBI genetic code ID
+bool CoreIsGeneticCode(int code){
+
+  for(size_t i = 0; i < sizeof(GENETIC_CODE_IDS) / sizeof(GENETIC_CODE_IDS[0]); i++){
+
+    if(GENETIC_CODE_IDS[i] == code){
+
+      return true;
+    }
+  }
+
+  return false;
+
+}
+
+  // Name: CoreGeneticCodeName
+  // Preconditions: None
+  // Postconditions: Returns the NCBI name of the code or "Unknown"
+const char *CoreGeneticCodeName(int code){
+
+  switch(code){
+
+#define NAME_CASE(ID) case ID: return GeneticCodeSpec<ID>::NAME;
+    FOR_EACH_GENETIC_CODE(NAME_CASE)
+#undef NAME_CASE
+
+    default:
+      return "Unknown";
+  }
+
+}
+
+  // Name: CoreResidueName
+  // Desc: Full name of a one-letter residue as the menu displays it
+  // Preconditions: None
+  // Postconditions: Returns a static string ("Unknown" for unrecognized codes)
+const char *CoreResidueName(char residue){
+
+  switch(residue){
+    case 'I': return "Isoleucine";
+    case 'L': return "Leucine";
+    case 'V': return "Valine";
+    case 'F': return "Phenylalanine";
+    case 'M': return "Methionine (START)";
+    case 'C': return "Cysteine";
+    case 'A': return "Alanine";
+    case 'G': return "Glycine";
+    case 'P': return "Proline";
+    case 'T': return "Threonine";
+    case 'S': return "Serine";
+    case 'Y': return "Tyrosine";
+    case 'W': return "Tryptophan";
+    case 'Q': return "Glutamine";
+    case 'N': return "Asparagine";
+    case 'H': return "Histidine";
+    case 'E': return "Glutamic acid";
+    case 'D': return "Aspartic acid";
+    case 'K': return "Lysine";
+    case 'R': return "Arginine";
+    case '*': return "Stop";
+    default: return "Unknown";
+  }
+
+}
+
+  // Name: CoreStatusMessage
+  // Preconditions: None
+  // Postconditions: Returns a static description of a return code
+const char *CoreStatusMessage(int status){
+
+  switch(status){
+    case CORE_OK: return "ok";
+    case CORE_INVALID_BASE: return "invalid base in sequence";
+    case CORE_BUFFER_TOO_SMALL: return "output buffer too small";
+    case CORE_BAD_ARGUMENT: return "bad argument";
+    case CORE_UNKNOWN_CODE: return "unknown genetic code";
+    default: return "unknown status";
+  }
+
+}
@@ -0,0 +1,89 @@
+//Title: SequencerCore.h
+//Author: Hazael Magino
+//Date: 10/19/2026
+//Description: Headless compute core of the sequencer (libsequencer). Transcribes and
+//             translates spans of bases into caller-provided buffers and reports
+//             problems through return codes. It does no console I/O and does not
+//             depend on Sequencer or Strand, so SequencerCore.cpp and TranslateKernel.cpp
+//             build on their own into libsequencer.a (make libsequencer.a) and can be
+//             embedded in other pipelines.
+
+#ifndef SEQUENCERCORE_H
+#define SEQUENCERCORE_H
+
+#include <cstddef>
+#include "GeneticCode.h"
+
+// Return codes of every core call
+const int CORE_OK = 0;
+const int CORE_INVALID_BASE = -1; //Input held something other than A, C, G, T or U
+const int CORE_BUFFER_TOO_SMALL = -2; //Output capacity is less than the result
+const int CORE_BAD_ARGUMENT = -3; //Null pointer with a non-zero length
+const int CORE_UNKNOWN_CODE = -4; //Not an NCBI genetic code ID
+
+// Read-only view of a sequence (not null terminated)
+struct BaseSpan {
+  const char *m_data;
+  size_t m_length;
+};
+
+// Caller-owned output buffer; m_length is set by the call
+struct OutputSpan {
+  char *m_data;
+  size_t m_capacity;
+  size_t m_length;
+};
+
+// Name: CoreTranscribe
+// Desc: Transcribes DNA to mRNA (A->U, T->A, C->G, G->C)
+// Preconditions: output.m_capacity >= dna.m_length
+// Postconditions: Returns CORE_OK and output holds the mRNA, or an error code;
+//                 on CORE_INVALID_BASE output.m_length is the offset of the bad base
+int CoreTranscribe(BaseSpan dna, OutputSpan &output);
+// Name: CoreTranslate
+// Desc: Translates mRNA three bases at a time into one-letter residues ('*' for
+//       Stop) using NCBI genetic code `code` (the standard code by default).
+//       Incomplete trailing codons are ignored. The code is dispatched once per
+//       call to a loop compiled for that code's table.
+// Preconditions: output.m_capacity >= mRNA.m_length / 3
+// Postconditions: Returns CORE_OK and output holds the protein, or an error code;
+//                 on CORE_INVALID_BASE the whole protein is still written with 'X'
+//                 for each codon that held a bad base
+int CoreTranslate(BaseSpan mRNA, OutputSpan &output, int code = DEFAULT_GENETIC_CODE);
+// Name: CoreTranscribeBatch
+// Desc: Transcribes count sequences into count caller-provided buffers
+// Preconditions: inputs and outputs have count entries
+// Postconditions: Returns CORE_OK, or the first error with *failed set to its
+//                 index (the other sequences are still processed)
+int CoreTranscribeBatch(const BaseSpan *inputs, OutputSpan *outputs, size_t count, size_t *failed);
+// Name: CoreTranslateBatch
+// Desc: Translates count mRNA sequences into count caller-provided buffers
+// Preconditions: inputs and outputs have count entries
+// Postconditions: Returns CORE_OK, or the first error with *failed set to its
+//                 index (the other sequences are still processed)
+int CoreTranslateBatch(const BaseSpan *inputs, OutputSpan *outputs, size_t count, size_t *failed,
+                       int code = DEFAULT_GENETIC_CODE);
+// Name: CoreCodonToResidue
+// Desc: Looks up the one-letter code of one codon in NCBI genetic code `code`
+// Preconditions: codon points at three chars
+// Postconditions: Returns the residue, '*' for Stop or 'X' if a base or the code is invalid
+char CoreCodonToResidue(const char *codon, int code = DEFAULT_GENETIC_CODE);
+// Name: CoreIsGeneticCode
+// Preconditions: None
+// Postconditions: Returns true if code is an NCBI genetic code ID
+bool CoreIsGeneticCode(int code);
+// Name: CoreGeneticCodeName
+// Preconditions: None
+// Postconditions: Returns the NCBI name of the code or "Unknown"
+const char *CoreGeneticCodeName(int code);
+// Name: CoreResidueName
+// Desc: Full name of a one-letter residue as the menu displays it
+// Preconditions: None
+// Postconditions: Returns a static string ("Unknown" for unrecognized codes)
+const char *CoreResidueName(char residue);
+// Name: CoreStatusMessage
+// Preconditions: None
+// Postconditions: Returns a static description of a return code
+const char *CoreStatusMessage(int status);
+
+#endif
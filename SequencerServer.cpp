@@ -0,0 +1,517 @@
+// File:    SequencerServer.cpp
+// Author:  Hazael Magino
+// Date:    10/19/2026
+// Section: Section 12
+// E-mail:  hazaelm1@umbc.edu
+// Description: Resident server mode for the sequencer. Strands are loaded once and
+// requests arrive over a Unix domain socket. One reader thread per client queues
+// requests and a pool of workers answers them in batches, so a query costs a queue
+// hop and the work itself instead of a full reload of the file. Each batch is answered
+// from the latest published strand snapshot, so serving starts while the file loads.
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <list>
+#include <cstring>
+#include <csignal>
+#include <cerrno>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "SequencerServer.h"
+#include "SequencerCore.h"
+
+using namespace std;
+
+const size_t MAX_PAYLOAD = 1 << 20; //Largest request payload accepted
+const unsigned int MAX_BATCH = 64; //Requests a worker takes from the queue at once
+const int POLL_MS = 200; //How often the accept loop checks for shutdown
+
+volatile sig_atomic_t g_stopSignal = 0; //Set by SIGINT or SIGTERM
+
+  // Name: HandleStop
+  // Desc: Signal handler that asks the server to shut down
+  // Preconditions: Installed for SIGINT and SIGTERM
+  // Postconditions: g_stopSignal is set
+static void HandleStop(int){
+
+  g_stopSignal = 1;
+
+}
+
+  // Name: ReadFully
+  // Desc: Reads exactly length bytes unless the peer closes or errors
+  // Preconditions: fd is an open socket
+  // Postconditions: Returns true if all bytes were read
+static bool ReadFully(int fd, void *data, size_t length){
+
+  char *curr = (char *)data;
+
+  while(length > 0){
+
+    ssize_t got = read(fd, curr, length);
+
+    if((got < 0) && (errno == EINTR)){
+
+      continue;
+    }
+
+    if(got <= 0){
+
+      return false;
+    }
+
+    curr += got;
+
+    length -= got;
+  }
+
+  return true;
+
+}
+
+  // Name: WriteFully
+  // Desc: Writes exactly length bytes unless the peer closes or errors
+  // Preconditions: fd is an open socket
+  // Postconditions: Returns true if all bytes were written
+static bool WriteFully(int fd, const void *data, size_t length){
+
+  const char *curr = (const char *)data;
+
+  while(length > 0){
+
+    ssize_t sent = send(fd, curr, length, MSG_NOSIGNAL);
+
+    if((sent < 0) && (errno == EINTR)){
+
+      continue;
+    }
+
+    if(sent <= 0){
+
+      return false;
+    }
+
+    curr += sent;
+
+    length -= sent;
+  }
+
+  return true;
+
+}
+
+Connection::Connection(int fd){
+
+  m_fd = fd;
+
+}
+
+Connection::~Connection(){
+
+  close(m_fd);
+
+}
+
+  // Name: SequencerServer (constructor)
+  // Desc: Creates a server over the strands published by source. Every batch of
+  //       requests is answered from the latest snapshot, so the server can start
+  //       while the strands are still loading.
+  // Preconditions: source always returns a snapshot
+  // Postconditions: Server is ready to Run
+SequencerServer::SequencerServer(SnapshotSource source, int threads)
+  : m_source(source){
+
+  m_threads = max(threads, 1);
+
+  m_stopping = false;
+
+}
+
+  // Name: Run
+  // Desc: Listens on socketPath and serves requests until SIGINT or SIGTERM
+  // Preconditions: socketPath is a writable path (an old socket file is replaced)
+  // Postconditions: Returns true after a clean shutdown, false if the socket
+  //                 could not be opened
+bool SequencerServer::Run(const string &socketPath){
+
+  sockaddr_un address;
+
+  memset(&address, 0, sizeof(address));
+
+  address.sun_family = AF_UNIX;
+
+  if(socketPath.length() >= sizeof(address.sun_path)){
+
+    cout << "Socket path is too long: " << socketPath << endl;
+
+    return false;
+  }
+
+  strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+
+  int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+
+  unlink(socketPath.c_str());
+
+  if((listener < 0) || (bind(listener, (sockaddr *)&address, sizeof(address)) != 0) ||
+     (listen(listener, SOMAXCONN) != 0)){
+
+    cout << "Error opening socket " << socketPath << ": " << strerror(errno) << endl;
+
+    if(listener >= 0){
+
+      close(listener);
+    }
+
+    return false;
+  }
+
+  signal(SIGINT, HandleStop);
+
+  signal(SIGTERM, HandleStop);
+
+  vector<thread> workers;
+
+  for(int t = 0; t < m_threads; t++){
+
+    workers.push_back(thread(&SequencerServer::WorkLoop, this));
+  }
+
+  shared_ptr<const StrandSnapshot> snapshot = m_source();
+
+  cout << "Serving " << snapshot->m_strands.size() << " strand(s) on " << socketPath
+       << (snapshot->m_complete ? "" : " (more are still loading)") << endl;
+
+  // Accept clients until asked to stop; each client gets its own reader thread
+
+  list<ClientReader> readers;
+
+  while(!g_stopSignal){
+
+    // Forget readers whose clients have disconnected
+
+    for(auto reader = readers.begin(); reader != readers.end(); ){
+
+      if(*reader->m_done){
+
+        reader->m_thread.join();
+
+        reader = readers.erase(reader);
+
+      }else{
+
+        reader++;
+      }
+    }
+
+    pollfd waiting = {listener, POLLIN, 0};
+
+    if(poll(&waiting, 1, POLL_MS) <= 0){
+
+      continue;
+    }
+
+    int client = accept(listener, nullptr, nullptr);
+
+    if(client < 0){
+
+      continue;
+    }
+
+    shared_ptr<Connection> connection = make_shared<Connection>(client);
+
+    shared_ptr<atomic<bool> > done = make_shared<atomic<bool> >(false);
+
+    readers.push_back(ClientReader());
+
+    readers.back().m_connection = connection;
+
+    readers.back().m_done = done;
+
+    readers.back().m_thread = thread([this, connection, done](){
+
+      ReadRequests(connection);
+
+      *done = true;
+    });
+  }
+
+  close(listener);
+
+  unlink(socketPath.c_str());
+
+  // Wake readers that are blocked on idle clients, then wait for them
+
+  m_stopping = true;
+
+  for(auto reader = readers.begin(); reader != readers.end(); reader++){
+
+    shared_ptr<Connection> connection = reader->m_connection.lock();
+
+    if(connection != nullptr){
+
+      shutdown(connection->m_fd, SHUT_RD);
+    }
+
+    reader->m_thread.join();
+  }
+
+  // Let the workers finish what is already queued
+
+  m_queueReady.notify_all();
+
+  for(unsigned int t = 0; t < workers.size(); t++){
+
+    workers.at(t).join();
+  }
+
+  cout << "Server stopped" << endl;
+
+  return true;
+
+}
+
+  // Name: ReadRequests
+  // Desc: Reads requests from one client and queues them until it disconnects
+  // Preconditions: connection is open
+  // Postconditions: Every complete request from the client has been queued
+void SequencerServer::ReadRequests(shared_ptr<Connection> connection){
+
+  ServerJob job;
+
+  job.m_connection = connection;
+
+  while(!m_stopping && ReadFully(connection->m_fd, &job.m_header, sizeof(job.m_header))){
+
+    if(job.m_header.m_length > MAX_PAYLOAD){
+
+      // The stream cannot be resynchronized after an oversized request
+
+      ResponseHeader response = {job.m_header.m_id, STATUS_TOO_LARGE, 0};
+
+      lock_guard<mutex> guard(connection->m_writeLock);
+
+      WriteFully(connection->m_fd, &response, sizeof(response));
+
+      return;
+    }
+
+    job.m_payload.resize(job.m_header.m_length);
+
+    if((job.m_header.m_length > 0) && !ReadFully(connection->m_fd, &job.m_payload[0], job.m_header.m_length)){
+
+      return;
+    }
+
+    {
+      lock_guard<mutex> guard(m_queueLock);
+
+      m_queue.push_back(job);
+    }
+
+    m_queueReady.notify_one();
+  }
+
+}
+
+  // Name: WorkLoop
+  // Desc: Takes batches of queued requests and answers them until shutdown
+  // Preconditions: None
+  // Postconditions: Returns once m_stopping is set and the queue is empty
+void SequencerServer::WorkLoop(){
+
+  vector<ServerJob> batch;
+
+  string payload;
+
+  while(true){
+
+    {
+      unique_lock<mutex> guard(m_queueLock);
+
+      m_queueReady.wait(guard, [this](){ return m_stopping || !m_queue.empty(); });
+
+      if(m_queue.empty()){
+
+        return;
+      }
+
+      // One lock round trip hands a worker up to MAX_BATCH requests
+
+      while(!m_queue.empty() && (batch.size() < MAX_BATCH)){
+
+        batch.push_back(m_queue.front());
+
+        m_queue.pop_front();
+      }
+    }
+
+    // The whole batch is answered from one snapshot, taken without a lock
+
+    shared_ptr<const StrandSnapshot> snapshot = m_source();
+
+    for(unsigned int i = 0; i < batch.size(); i++){
+
+      ServerJob &job = batch.at(i);
+
+      payload.clear();
+
+      int32_t status = Answer(*snapshot, job, payload);
+
+      ResponseHeader response = {job.m_header.m_id, status, uint32_t(payload.length())};
+
+      lock_guard<mutex> guard(job.m_connection->m_writeLock);
+
+      if(WriteFully(job.m_connection->m_fd, &response, sizeof(response))){
+
+        WriteFully(job.m_connection->m_fd, payload.data(), payload.length());
+      }
+    }
+
+    batch.clear();
+  }
+
+}
+
+  // Name: Answer
+  // Desc: Runs one request against a snapshot of the loaded strands
+  // Preconditions: None
+  // Postconditions: Returns the status; payload holds the response body
+int32_t SequencerServer::Answer(const StrandSnapshot &snapshot, const ServerJob &job, string &payload){
+
+  const RequestHeader &header = job.m_header;
+
+  const vector<Strand*> &strands = snapshot.m_strands;
+
+  // Until loading finishes a missing strand may still show up
+
+  int32_t missing = snapshot.m_complete ? STATUS_BAD_STRAND : STATUS_NOT_LOADED;
+
+  if((header.m_op == OP_STAT) && (header.m_strand == ALL_STRANDS)){
+
+    uint32_t count = strands.size();
+
+    uint64_t bases = 0;
+
+    for(unsigned int i = 0; i < strands.size(); i++){
+
+      bases += strands.at(i)->GetSize();
+    }
+
+    payload.append((const char *)&count, sizeof(count));
+
+    payload.append((const char *)&bases, sizeof(bases));
+
+    return STATUS_OK;
+  }
+
+  // Names are looked up without a strand index
+
+  if(header.m_op == OP_FIND){
+
+    unordered_map<string, int>::const_iterator found = snapshot.m_names.find(job.m_payload);
+
+    if(found == snapshot.m_names.end()){
+
+      return missing;
+    }
+
+    uint32_t index = found->second;
+
+    payload.append((const char *)&index, sizeof(index));
+
+    return STATUS_OK;
+  }
+
+  if(header.m_strand >= strands.size()){
+
+    return missing;
+  }
+
+  Strand *strand = strands.at(header.m_strand);
+
+  switch(header.m_op){
+
+    case OP_STAT: {
+
+      uint32_t size = strand->GetSize();
+
+      payload.append((const char *)&size, sizeof(size));
+
+      payload += strand->GetName();
+
+      return STATUS_OK;
+    }
+
+    case OP_TRANSCRIBE:
+    case OP_TRANSLATE: {
+
+      // Pinned so other workers cannot evict the bases under a memory budget
+
+      if(!strand->Pin()){
+
+        return STATUS_UNREADABLE;
+      }
+
+      BaseSpan dna = {strand->GetBuffer(), size_t(strand->GetSize())};
+
+      string mRNA(dna.m_length, '\0');
+
+      OutputSpan transcribed = {&mRNA[0], mRNA.size(), 0};
+
+      int status = CoreTranscribe(dna, transcribed);
+
+      strand->Unpin();
+
+      if(status != CORE_OK){
+
+        return STATUS_INVALID_BASE;
+      }
+
+      if(header.m_op == OP_TRANSCRIBE){
+
+        payload.swap(mRNA);
+
+        return STATUS_OK;
+      }
+
+      BaseSpan input = {mRNA.data(), mRNA.size()};
+
+      payload.resize(mRNA.size() / 3);
+
+      OutputSpan protein = {&payload[0], payload.size(), 0};
+
+      CoreTranslate(input, protein, snapshot.m_codes.at(header.m_strand));
+
+      return STATUS_OK;
+    }
+
+    case OP_SEARCH: {
+
+      if(!strand->Pin()){
+
+        return STATUS_UNREADABLE;
+      }
+
+      for(int pos = strand->Find(job.m_payload); pos != -1; pos = strand->Find(job.m_payload, pos + 1)){
+
+        uint32_t match = pos;
+
+        payload.append((const char *)&match, sizeof(match));
+      }
+
+      strand->Unpin();
+
+      return STATUS_OK;
+    }
+
+    default:
+
+      return STATUS_BAD_OP;
+  }
+
+}
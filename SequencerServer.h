@@ -0,0 +1,120 @@
+//Title: SequencerServer.h
+//Author: Hazael Magino
+//Date: 10/19/2026
+//Description: Resident server mode. Serves transcribe, translate, search, stat and find
+//             requests for strands that were loaded once, over a Unix domain socket
+//             with a small binary protocol. Requests from all clients go into one
+//             queue and are drained in batches by a pool of worker threads.
+
+#ifndef SEQUENCERSERVER_H
+#define SEQUENCERSERVER_H
+
+#include "Strand.h"
+#include "StrandSnapshot.h"
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <thread>
+#include <cstdint>
+using namespace std;
+
+// Request operations
+const uint16_t OP_STAT = 1; //Strand count and total bases, or one strand's size and name
+const uint16_t OP_TRANSCRIBE = 2; //mRNA bases of a DNA strand
+const uint16_t OP_TRANSLATE = 3; //One-letter protein of a DNA strand
+const uint16_t OP_SEARCH = 4; //Positions (uint32) where the payload occurs in a strand
+const uint16_t OP_FIND = 5; //Index (uint32) of the first strand named by the payload
+
+// Response statuses
+const int32_t STATUS_OK = 0;
+const int32_t STATUS_BAD_STRAND = -1;
+const int32_t STATUS_BAD_OP = -2;
+const int32_t STATUS_TOO_LARGE = -3;
+const int32_t STATUS_INVALID_BASE = -4;
+const int32_t STATUS_NOT_LOADED = -5; //Strand may exist but is still being loaded; retry later
+const int32_t STATUS_UNREADABLE = -6; //Strand's bases could not be read back from the input or spill file
+
+const uint32_t ALL_STRANDS = 0xFFFFFFFF; //Strand index for corpus-wide OP_STAT
+
+// Every request is this header (host byte order) followed by m_length payload bytes
+struct RequestHeader {
+  uint32_t m_id; //Echoed back in the response so clients can pipeline requests
+  uint16_t m_op; //One of the OP_ values
+  uint16_t m_reserved; //Must be 0
+  uint32_t m_strand; //Index into the loaded DNA strands
+  uint32_t m_length; //Payload bytes that follow
+};
+
+// Every response is this header followed by m_length payload bytes
+struct ResponseHeader {
+  uint32_t m_id; //Id of the request being answered
+  int32_t m_status; //STATUS_OK or a negative error code
+  uint32_t m_length; //Payload bytes that follow
+};
+
+// One client socket; closed once the reader and every pending request let go of it
+struct Connection {
+  int m_fd;
+  mutex m_writeLock; //Keeps responses from different workers from interleaving
+  Connection(int fd);
+  ~Connection();
+};
+
+struct ServerJob {
+  shared_ptr<Connection> m_connection;
+  RequestHeader m_header;
+  string m_payload;
+};
+
+// A client's reader thread and whether it has finished
+struct ClientReader {
+  thread m_thread;
+  weak_ptr<Connection> m_connection;
+  shared_ptr<atomic<bool> > m_done;
+};
+
+class SequencerServer {
+ public:
+  // Name: SequencerServer (constructor)
+  // Desc: Creates a server over the strands published by source. Every batch of
+  //       requests is answered from the latest snapshot, so the server can start
+  //       while the strands are still loading.
+  // Preconditions: source always returns a snapshot
+  // Postconditions: Server is ready to Run
+  SequencerServer(SnapshotSource source, int threads);
+  // Name: Run
+  // Desc: Listens on socketPath and serves requests until SIGINT or SIGTERM
+  // Preconditions: socketPath is a writable path (an old socket file is replaced)
+  // Postconditions: Returns true after a clean shutdown, false if the socket
+  //                 could not be opened
+  bool Run(const string &socketPath);
+ private:
+  // Name: ReadRequests
+  // Desc: Reads requests from one client and queues them until it disconnects
+  // Preconditions: connection is open
+  // Postconditions: Every complete request from the client has been queued
+  void ReadRequests(shared_ptr<Connection> connection);
+  // Name: WorkLoop
+  // Desc: Takes batches of queued requests and answers them until shutdown
+  // Preconditions: None
+  // Postconditions: Returns once m_stopping is set and the queue is empty
+  void WorkLoop();
+  // Name: Answer
+  // Desc: Runs one request against a snapshot of the loaded strands
+  // Preconditions: None
+  // Postconditions: Returns the status; payload holds the response body
+  int32_t Answer(const StrandSnapshot &snapshot, const ServerJob &job, string &payload);
+  SnapshotSource m_source; //Latest snapshot of the loaded strands
+  int m_threads; //Worker threads
+  deque<ServerJob> m_queue; //Requests waiting for a worker
+  mutex m_queueLock;
+  condition_variable m_queueReady;
+  atomic<bool> m_stopping; //Set when the server shuts down
+};
+
+#endif
@@ -0,0 +1,485 @@
+// File:    ShardRunner.cpp
+// Author:  Hazael Magino
+// Date:    10/19/2026
+// Section: Section 12
+// E-mail:  hazaelm1@umbc.edu
+// Description: Multi-process shard mode. Workers are plain fork()ed copies of this
+// process that each read only their own part of the input and write tagged entries
+// to a shard file; the parent waits for every worker and merges the shard files by
+// record offset, so the output order never depends on which worker finished first.
+
+#include <string>
+#include <vector>
+#include <queue>
+#include <iostream>
+#include <cstdio>
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include "ShardRunner.h"
+#include "SequencerCore.h"
+#include "GzipReader.h"
+#include "BatchJob.h"
+
+using namespace std;
+
+const size_t SHARD_CHUNK = 1 << 20; //Bytes a worker reads from a plain file at a time
+
+  // Name: ShardRunner (constructor)
+  // Desc: Prepares a shard run over fileName. codeFor gives the genetic code of a strand.
+  // Preconditions: shards >= 1
+  // Postconditions: Nothing is read or forked until Run
+ShardRunner::ShardRunner(string fileName, int shards, bool byHash, int threads,
+                         const function<int(const string &)> &codeFor){
+
+  m_fileName = fileName;
+
+  m_shards = max(shards, 1);
+
+  m_byHash = byHash;
+
+  m_threads = max(threads, 1);
+
+  m_codeFor = codeFor;
+
+  m_records = 0;
+
+}
+
+  // Name: Run
+  // Desc: Forks one worker per shard, waits for all of them and merges their
+  //       proteins into outFile in input order
+  // Preconditions: No other threads are running in this process (fork safety)
+  // Postconditions: Returns true and fills outFile if every worker succeeded;
+  //                 otherwise returns false with error set and outFile untouched
+bool ShardRunner::Run(string outFile, string &error){
+
+  vector<string> shardFiles;
+
+  vector<pid_t> workers;
+
+  // Buffered output would otherwise be flushed once by every child as well
+
+  cout.flush();
+
+  for(int s = 0; s < m_shards; s++){
+
+    shardFiles.push_back(outFile + ".shard" + to_string(s));
+
+    pid_t pid = fork();
+
+    if(pid < 0){
+
+      error = string("fork failed: ") + strerror(errno);
+
+      break;
+    }
+
+    if(pid == 0){
+
+      bool ok = RunWorker(s, shardFiles.back());
+
+      cout.flush();
+
+      _exit(ok ? 0 : 1);
+    }
+
+    workers.push_back(pid);
+  }
+
+  // Every started worker is reaped, even after a failure, so none is left behind
+
+  for(unsigned int s = 0; s < workers.size(); s++){
+
+    int status = 0;
+
+    while((waitpid(workers.at(s), &status, 0) < 0) && (errno == EINTR)){
+    }
+
+    if(WIFSIGNALED(status) && error.empty()){
+
+      error = "shard " + to_string(s) + " was killed by signal " + to_string(WTERMSIG(status));
+
+    }else if((!WIFEXITED(status) || (WEXITSTATUS(status) != 0)) && error.empty()){
+
+      error = "shard " + to_string(s) + " failed";
+    }
+  }
+
+  bool merged = error.empty() && Merge(shardFiles, outFile, error);
+
+  for(unsigned int s = 0; s < shardFiles.size(); s++){
+
+    remove(shardFiles.at(s).c_str());
+  }
+
+  return merged;
+
+}
+
+  // Name: GetRecordCount
+  // Preconditions: Run has returned true
+  // Postconditions: Returns the number of proteins written
+int ShardRunner::GetRecordCount(){
+
+  return m_records;
+
+}
+
+  // Name: GetSkipped
+  // Preconditions: Run has returned true
+  // Postconditions: Returns the names of the records skipped for invalid bases, in input order
+const vector<string> &ShardRunner::GetSkipped(){
+
+  return m_skipped;
+
+}
+
+  // Name: HashName (static)
+  // Desc: FNV-1a hash of a strand name; stable across processes and runs
+  // Preconditions: None
+  // Postconditions: Returns the 64 bit hash
+uint64_t ShardRunner::HashName(const char *name, size_t length){
+
+  uint64_t hash = 14695981039346656037ULL;
+
+  for(size_t i = 0; i < length; i++){
+
+    hash ^= (unsigned char)name[i];
+
+    hash *= 1099511628211ULL;
+  }
+
+  return hash;
+
+}
+
+  // Name: RunWorker
+  // Desc: Body of a worker process. Scans its part of the input and writes one
+  //       ShardEntry per record it owns to shardFile.
+  // Preconditions: Called in the forked child
+  // Postconditions: Returns true if the input was read and shardFile written
+bool ShardRunner::RunWorker(int shard, string shardFile){
+
+  ofstream output(shardFile, ios::binary);
+
+  if(!output.is_open()){
+
+    cout << "Shard " << shard << ": error opening " << shardFile << endl;
+
+    return false;
+  }
+
+  // A compressed stream cannot be entered mid-way, so it is always split by hash
+
+  bool compressed = GzipReader::IsCompressed(m_fileName);
+
+  bool byHash = m_byHash || compressed;
+
+  uint64_t begin = 0; // records starting in [begin, end) belong to this shard
+
+  uint64_t end = UINT64_MAX;
+
+  if(!byHash){
+
+    struct stat info;
+
+    if(stat(m_fileName.c_str(), &info) != 0){
+
+      cout << "Shard " << shard << ": error reading " << m_fileName << endl;
+
+      return false;
+    }
+
+    begin = uint64_t(info.st_size) * shard / m_shards;
+
+    end = uint64_t(info.st_size) * (shard + 1) / m_shards;
+  }
+
+  // Reading starts one byte early; everything up to the first line break belongs to
+  // the previous shard (just the line break itself if a record starts at begin)
+
+  uint64_t streamOffset = (begin > 0) ? begin - 1 : 0; // offset of the next byte fed in
+
+  bool skipFirst = (begin > 0);
+
+  bool done = false;
+
+  string pending = "";
+
+  uint64_t pendingOffset = 0;
+
+  auto handleLine = [&](const char *line, size_t length, uint64_t offset){
+
+    if(skipFirst){
+
+      skipFirst = false;
+
+      return;
+    }
+
+    if(offset >= end){
+
+      done = true;
+
+      return;
+    }
+
+    if(byHash){
+
+      const char *comma = (const char *)memchr(line, ',', length);
+
+      size_t nameLength = (comma == nullptr) ? length : comma - line;
+
+      if(HashName(line, nameLength) % m_shards != uint64_t(shard)){
+
+        return;
+      }
+    }
+
+    ProcessRecord(line, length, offset, output);
+  };
+
+  TextSink sink = [&](const char *data, size_t length){
+
+    const char *start = data;
+
+    const char *stop = data + length;
+
+    while((data < stop) && !done){
+
+      const char *lineEnd = (const char *)memchr(data, '\n', stop - data);
+
+      uint64_t offset = streamOffset + (data - start);
+
+      if(lineEnd == nullptr){
+
+        if(pending.empty()){
+
+          pendingOffset = offset;
+        }
+
+        pending.append(data, stop - data);
+
+        break;
+      }
+
+      if(pending.empty()){
+
+        handleLine(data, lineEnd - data, offset);
+
+      }else{
+
+        pending.append(data, lineEnd - data);
+
+        handleLine(pending.data(), pending.length(), pendingOffset);
+
+        pending.clear();
+      }
+
+      data = lineEnd + 1;
+    }
+
+    streamOffset += length;
+  };
+
+  string error = "";
+
+  if(compressed){
+
+    if(!GzipReader::Read(m_fileName, m_threads, sink, error)){
+
+      cout << "Shard " << shard << ": error reading file: " << error << endl;
+
+      return false;
+    }
+
+  }else{
+
+    ifstream inputData(m_fileName, ios::binary);
+
+    if(!inputData.is_open()){
+
+      cout << "Shard " << shard << ": error reading " << m_fileName << endl;
+
+      return false;
+    }
+
+    inputData.seekg(streamOffset);
+
+    vector<char> buffer(SHARD_CHUNK);
+
+    while(!done && (inputData.read(buffer.data(), SHARD_CHUNK) || (inputData.gcount() > 0))){
+
+      sink(buffer.data(), inputData.gcount());
+    }
+  }
+
+  // The last record may not end with a line break
+
+  if(!done && !pending.empty()){
+
+    handleLine(pending.data(), pending.length(), pendingOffset);
+  }
+
+  output.close();
+
+  return !output.fail();
+
+}
+
+  // Name: ProcessRecord
+  // Desc: Transcribes and translates one "name,bases" line and writes its entry
+  // Preconditions: line is one record without its line break
+  // Postconditions: One ShardEntry is written to output
+void ShardRunner::ProcessRecord(const char *line, size_t length, uint64_t offset, ofstream &output){
+
+  string name;
+
+  string payload;
+
+  int status = BatchJob::ConvertRecord(line, length, m_codeFor, m_mRNA, name, payload);
+
+  if(status == CORE_BAD_ARGUMENT){
+
+    return;
+  }
+
+  // A skipped record carries its name so the parent can report it in order
+
+  if(status != CORE_OK){
+
+    payload = name;
+  }
+
+  ShardEntry entry = {offset, uint32_t(payload.length()), status};
+
+  output.write((const char *)&entry, sizeof(entry));
+
+  output.write(payload.data(), payload.length());
+
+}
+
+  // Name: Merge
+  // Desc: k-way merges the shard files by record offset into outFile. The merge is
+  //       written to outFile.tmp, which replaces outFile only once it is complete.
+  // Preconditions: Every worker exited successfully
+  // Postconditions: Returns true if outFile was written; otherwise outFile is untouched
+bool ShardRunner::Merge(const vector<string> &shardFiles, string outFile, string &error){
+
+  vector<ifstream> inputs(shardFiles.size());
+
+  vector<ShardEntry> heads(shardFiles.size());
+
+  // Min-heap of (offset, shard) over the next entry of every shard file
+
+  priority_queue<pair<uint64_t, int>, vector<pair<uint64_t, int> >, greater<pair<uint64_t, int> > > next;
+
+  // Queues the shard's next entry; false if the file ends inside an entry header
+
+  auto readHead = [&](int s){
+
+    if(inputs.at(s).read((char *)&heads.at(s), sizeof(ShardEntry))){
+
+      next.push(make_pair(heads.at(s).m_offset, s));
+
+      return true;
+    }
+
+    return inputs.at(s).gcount() == 0;
+  };
+
+  for(unsigned int s = 0; s < shardFiles.size(); s++){
+
+    inputs.at(s).open(shardFiles.at(s), ios::binary);
+
+    if(!inputs.at(s).is_open()){
+
+      error = "missing output of shard " + to_string(s);
+
+      return false;
+    }
+
+    if(!readHead(s)){
+
+      error = "output of shard " + to_string(s) + " is truncated";
+
+      return false;
+    }
+  }
+
+  string tempFile = outFile + ".tmp";
+
+  ofstream outputData(tempFile, ios::binary);
+
+  if(!outputData.is_open()){
+
+    error = "error opening " + tempFile;
+
+    return false;
+  }
+
+  m_records = 0;
+
+  m_skipped.clear();
+
+  string payload;
+
+  while(error.empty() && !next.empty()){
+
+    int s = next.top().second;
+
+    next.pop();
+
+    payload.resize(heads.at(s).m_length);
+
+    if(!inputs.at(s).read(&payload[0], payload.length())){
+
+      error = "output of shard " + to_string(s) + " is truncated";
+
+      break;
+    }
+
+    if(heads.at(s).m_status == CORE_OK){
+
+      outputData.write(payload.data(), payload.length());
+
+      m_records++;
+
+    }else{
+
+      m_skipped.push_back(payload);
+    }
+
+    if(!readHead(s)){
+
+      error = "output of shard " + to_string(s) + " is truncated";
+    }
+  }
+
+  outputData.close();
+
+  if(error.empty() && outputData.fail()){
+
+    error = "error writing " + tempFile;
+  }
+
+  if(error.empty() && (rename(tempFile.c_str(), outFile.c_str()) != 0)){
+
+    error = "error replacing " + outFile;
+  }
+
+  // A failed merge leaves outFile as it was
+
+  if(!error.empty()){
+
+    remove(tempFile.c_str());
+
+    return false;
+  }
+
+  return true;
+
+}
@@ -0,0 +1,84 @@
+//Title: ShardRunner.h
+//Author: Hazael Magino
+//Date: 10/19/2026
+//Description: Multi-process shard mode. The records of one input file are split into
+//             shards by byte range or by a hash of the strand name, each shard is
+//             transcribed and translated by its own forked worker process, and the
+//             workers' outputs are merged back into input order. A crashing worker
+//             only loses its own shard and is reported by the parent.
+
+#ifndef SHARDRUNNER_H
+#define SHARDRUNNER_H
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <fstream>
+#include <cstdint>
+using namespace std;
+
+// Every entry in a worker's shard file is this header followed by m_length bytes:
+// the protein as FASTA, or the strand name when the record was skipped
+struct ShardEntry {
+  uint64_t m_offset; //Byte offset of the record in the (decompressed) input; the merge key
+  uint32_t m_length; //Payload bytes that follow
+  int32_t m_status; //0, or the core status that made the worker skip the record
+};
+
+class ShardRunner {
+ public:
+  // Name: ShardRunner (constructor)
+  // Desc: Prepares a shard run over fileName. codeFor gives the genetic code of a strand.
+  // Preconditions: shards >= 1
+  // Postconditions: Nothing is read or forked until Run
+  ShardRunner(string fileName, int shards, bool byHash, int threads,
+              const function<int(const string &)> &codeFor);
+  // Name: Run
+  // Desc: Forks one worker per shard, waits for all of them and merges their
+  //       proteins into outFile in input order
+  // Preconditions: No other threads are running in this process (fork safety)
+  // Postconditions: Returns true and fills outFile if every worker succeeded;
+  //                 otherwise returns false with error set and outFile untouched
+  bool Run(string outFile, string &error);
+  // Name: GetRecordCount
+  // Preconditions: Run has returned true
+  // Postconditions: Returns the number of proteins written
+  int GetRecordCount();
+  // Name: GetSkipped
+  // Preconditions: Run has returned true
+  // Postconditions: Returns the names of the records skipped for invalid bases, in input order
+  const vector<string> &GetSkipped();
+  // Name: HashName (static)
+  // Desc: FNV-1a hash of a strand name; stable across processes and runs
+  // Preconditions: None
+  // Postconditions: Returns the 64 bit hash
+  static uint64_t HashName(const char *name, size_t length);
+ private:
+  // Name: RunWorker
+  // Desc: Body of a worker process. Scans its part of the input and writes one
+  //       ShardEntry per record it owns to shardFile.
+  // Preconditions: Called in the forked child
+  // Postconditions: Returns true if the input was read and shardFile written
+  bool RunWorker(int shard, string shardFile);
+  // Name: ProcessRecord
+  // Desc: Transcribes and translates one "name,bases" line and writes its entry
+  // Preconditions: line is one record without its line break
+  // Postconditions: One ShardEntry is written to output
+  void ProcessRecord(const char *line, size_t length, uint64_t offset, ofstream &output);
+  // Name: Merge
+  // Desc: k-way merges the shard files by record offset into outFile. The merge is
+  //       written to outFile.tmp, which replaces outFile only once it is complete.
+  // Preconditions: Every worker exited successfully
+  // Postconditions: Returns true if outFile was written; otherwise outFile is untouched
+  bool Merge(const vector<string> &shardFiles, string outFile, string &error);
+  string m_fileName; //Input file
+  int m_shards; //Number of worker processes
+  bool m_byHash; //Partition by name hash instead of byte range
+  int m_threads; //Decompression threads per worker
+  function<int(const string &)> m_codeFor; //Genetic code of a strand
+  int m_records; //Proteins written by the merge
+  vector<string> m_skipped; //Records skipped by the workers
+  vector<char> m_mRNA; //Worker scratch for the transcribed strand
+};
+
+#endif
@@ -0,0 +1,481 @@
+// File:    SketchCluster.cpp
+// Author:  Hazael Magino
+// Date:    10/19/2026
+// Section: Section 12
+// E-mail:  hazaelm1@umbc.edu
+// Description: MinHash sketching and clustering. One-permutation hashing puts every
+// canonical k-mer hash into one of SKETCH_BINS bins by its top bits and keeps the
+// minimum per bin, so a sketch costs one pass over the strand. Two sketches agree in
+// a bin with probability equal to the Jaccard similarity of the k-mer sets. Only pairs
+// that agree on a whole LSH band are ever compared, which keeps clustering far below
+// all-vs-all cost.
+
+#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <cmath>
+#include <cstring>
+#include "SketchCluster.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+using namespace std;
+
+const int BAND_WINDOW = 8; //Earlier bucket members each strand is compared with
+const double BAND_RECALL = 0.99; //Chance a pair at the threshold shares a band
+const uint32_t EMPTY_BIN = 0xFFFFFFFF; //Bin that no k-mer hashed into
+const uint32_t DENSIFY_STEP = 0x9E3779B1; //Offset per bin borrowed across
+
+  // Name: MixHash
+  // Desc: 64 bit finalizer (splitmix64) used as the MinHash permutation
+  // Preconditions: None
+  // Postconditions: Returns the mixed value
+static inline uint64_t MixHash(uint64_t value){
+
+  value += 0x9E3779B97F4A7C15ULL;
+
+  value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+
+  value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+
+  return value ^ (value >> 31);
+
+}
+
+  // Name: SketchCluster (constructor)
+  // Desc: Clusters strands whose estimated ANI is at least minANI, using k-mers of length k
+  // Preconditions: 1 <= k <= 32; 0 < minANI <= 1
+  // Postconditions: Creates an empty clustering
+SketchCluster::SketchCluster(double minANI, int k){
+
+  m_k = min(max(k, 1), 32);
+
+  m_minANI = minANI;
+
+  // Invert the Mash distance: ANI = 1 + ln(2J / (1 + J)) / k
+
+  double shared = exp(-m_k * (1.0 - minANI));
+
+  m_minJaccard = shared / (2.0 - shared);
+
+  m_clusters = 0;
+
+  m_comparisons = 0;
+
+}
+
+  // Name: Build
+  // Desc: Sketches every strand on threads threads, then clusters them
+  // Preconditions: strands hold DNA or mRNA
+  // Postconditions: Every strand has a cluster, except those whose bases could not
+  //                 be loaded (see GetSkipped)
+void SketchCluster::Build(vector<Strand*> &strands, int threads){
+
+  int count = strands.size();
+
+  m_sketches.assign(count, StrandSketch());
+
+  m_skipped.clear();
+
+  atomic<int> next(0);
+
+  // Each worker claims the next unsketched strand until none are left
+
+  auto worker = [&](){
+
+    for(int i = next++; i < count; i = next++){
+
+      // Pinning keeps the buffer valid while other workers unpin (and evict)
+
+      if(!strands.at(i)->Pin()){
+
+        // Empty sketches are never banded, so the strand joins nothing
+
+        m_sketches.at(i).m_empty = true;
+
+        m_sketches.at(i).m_skipped = true;
+
+        continue;
+      }
+
+      Sketch(strands.at(i)->GetBuffer(), strands.at(i)->GetSize(), m_k, m_sketches.at(i));
+
+      strands.at(i)->Unpin();
+    }
+  };
+
+  vector<thread> pool;
+
+  for(int t = 1; t < threads; t++){
+
+    pool.push_back(thread(worker));
+  }
+
+  worker();
+
+  for(unsigned int t = 0; t < pool.size(); t++){
+
+    pool.at(t).join();
+  }
+
+  m_parent.resize(count);
+
+  for(int i = 0; i < count; i++){
+
+    m_parent.at(i) = i;
+
+    if(m_sketches.at(i).m_skipped){
+
+      m_skipped.push_back(strands.at(i)->GetName());
+    }
+  }
+
+  // Use the widest bands that still catch a pair at the threshold with BAND_RECALL
+
+  int rows = 1;
+
+  for(int r = 8; r > 1; r /= 2){
+
+    if(1.0 - pow(1.0 - pow(m_minJaccard, r), SKETCH_BINS / r) >= BAND_RECALL){
+
+      rows = r;
+
+      break;
+    }
+  }
+
+  vector<pair<uint64_t, int> > keys;
+
+  keys.reserve(count);
+
+  m_comparisons = 0;
+
+  for(int band = 0; band < SKETCH_BINS / rows; band++){
+
+    keys.clear();
+
+    for(int i = 0; i < count; i++){
+
+      if(m_sketches.at(i).m_empty){
+
+        continue;
+      }
+
+      uint64_t key = band;
+
+      for(int r = 0; r < rows; r++){
+
+        key = MixHash(key ^ m_sketches.at(i).m_bins[band * rows + r]);
+      }
+
+      keys.push_back(make_pair(key, i));
+    }
+
+    sort(keys.begin(), keys.end());
+
+    // Strands with the same band are candidates; each is checked against a few
+    // earlier members so a huge bucket of near-identical strands stays linear
+
+    unsigned int runStart = 0;
+
+    for(unsigned int j = 0; j < keys.size(); j++){
+
+      if(keys.at(j).first != keys.at(runStart).first){
+
+        runStart = j;
+      }
+
+      for(unsigned int p = max(int(runStart), int(j) - BAND_WINDOW); p < j; p++){
+
+        int a = keys.at(p).second;
+
+        int b = keys.at(j).second;
+
+        if(FindSet(a) == FindSet(b)){
+
+          continue;
+        }
+
+        m_comparisons++;
+
+        if(Jaccard(m_sketches.at(a), m_sketches.at(b)) >= m_minJaccard){
+
+          JoinSets(a, b);
+        }
+      }
+    }
+  }
+
+  // Number the clusters in order of their first strand
+
+  m_cluster.assign(count, -1);
+
+  m_clusters = 0;
+
+  for(int i = 0; i < count; i++){
+
+    if(m_sketches.at(i).m_skipped){
+
+      continue;
+    }
+
+    int root = FindSet(i);
+
+    if(m_cluster.at(root) < 0){
+
+      m_cluster.at(root) = m_clusters++;
+    }
+
+    m_cluster.at(i) = m_cluster.at(root);
+  }
+
+}
+
+  // Name: Sketch (static)
+  // Desc: Builds the MinHash sketch of the canonical k-mers of size bases.
+  //       K-mers containing anything but A, C, G, T or U are skipped.
+  // Preconditions: 1 <= k <= 32
+  // Postconditions: sketch is filled; empty bins are densified from their neighbours
+void SketchCluster::Sketch(const char *bases, int size, int k, StrandSketch &sketch){
+
+  static const struct DigitTable {
+    signed char m_digit[256];
+    DigitTable(){
+      memset(m_digit, -1, sizeof(m_digit));
+      m_digit[(unsigned char)'A'] = 0; m_digit[(unsigned char)'C'] = 1;
+      m_digit[(unsigned char)'G'] = 2; m_digit[(unsigned char)'T'] = 3;
+      m_digit[(unsigned char)'U'] = 3;
+    }
+  } TABLE;
+
+  const uint64_t mask = (k == 32) ? ~0ULL : ((1ULL << (2 * k)) - 1);
+
+  const int shift = 2 * (k - 1);
+
+  uint64_t forward = 0;
+
+  uint64_t reverse = 0;
+
+  int valid = 0; // bases since the last invalid one
+
+  bool filled = false;
+
+  for(int b = 0; b < SKETCH_BINS; b++){
+
+    sketch.m_bins[b] = EMPTY_BIN;
+  }
+
+  for(int i = 0; i < size; i++){
+
+    int digit = TABLE.m_digit[(unsigned char)bases[i]];
+
+    if(digit < 0){
+
+      valid = 0;
+
+      continue;
+    }
+
+    // Keep the k-mer and its reverse complement; the smaller one is canonical so a
+    // strand and its complement sketch the same
+
+    forward = ((forward << 2) | digit) & mask;
+
+    reverse = (reverse >> 2) | (uint64_t(3 - digit) << shift);
+
+    if(++valid < k){
+
+      continue;
+    }
+
+    uint64_t hash = MixHash(min(forward, reverse));
+
+    int bin = hash >> 57;
+
+    uint32_t value = uint32_t(hash >> 25);
+
+    if(value < sketch.m_bins[bin]){
+
+      sketch.m_bins[bin] = value;
+    }
+
+    filled = true;
+  }
+
+  sketch.m_empty = !filled;
+
+  if(!filled){
+
+    return;
+  }
+
+  // Densify by rotation: an empty bin borrows the next filled bin to its right,
+  // offset by the distance so that borrowed bins rarely match by accident
+
+  uint32_t original[SKETCH_BINS];
+
+  memcpy(original, sketch.m_bins, sizeof(original));
+
+  for(int b = 0; b < SKETCH_BINS; b++){
+
+    if(original[b] != EMPTY_BIN){
+
+      continue;
+    }
+
+    int distance = 1;
+
+    while(original[(b + distance) % SKETCH_BINS] == EMPTY_BIN){
+
+      distance++;
+    }
+
+    sketch.m_bins[b] = original[(b + distance) % SKETCH_BINS] + distance * DENSIFY_STEP;
+  }
+
+}
+
+  // Name: Jaccard (static)
+  // Desc: Estimates the Jaccard similarity of two k-mer sets from their sketches
+  // Preconditions: Both sketches were built with the same k
+  // Postconditions: Returns the fraction of equal bins (0 if either is empty)
+double SketchCluster::Jaccard(const StrandSketch &a, const StrandSketch &b){
+
+  if(a.m_empty || b.m_empty){
+
+    return 0.0;
+  }
+
+  int equal = 0;
+
+#ifdef __SSE2__
+  // Four bins per compare; movemask gives one bit per equal bin
+
+  for(int i = 0; i < SKETCH_BINS; i += 4){
+
+    __m128i left = _mm_loadu_si128((const __m128i *)(a.m_bins + i));
+
+    __m128i right = _mm_loadu_si128((const __m128i *)(b.m_bins + i));
+
+    equal += __builtin_popcount(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(left, right))));
+  }
+#else
+  for(int i = 0; i < SKETCH_BINS; i++){
+
+    equal += (a.m_bins[i] == b.m_bins[i]);
+  }
+#endif
+
+  return double(equal) / SKETCH_BINS;
+
+}
+
+  // Name: ToANI
+  // Desc: Converts a Jaccard estimate to average nucleotide identity (Mash distance)
+  // Preconditions: None
+  // Postconditions: Returns ANI in [0, 1]
+double SketchCluster::ToANI(double jaccard){
+
+  if(jaccard <= 0.0){
+
+    return 0.0;
+  }
+
+  double ani = 1.0 + log(2.0 * jaccard / (1.0 + jaccard)) / m_k;
+
+  return max(ani, 0.0);
+
+}
+
+  // Name: GetClusterCount
+  // Preconditions: Build has been called
+  // Postconditions: Returns the number of clusters (singletons included)
+int SketchCluster::GetClusterCount(){
+
+  return m_clusters;
+
+}
+
+  // Name: GetSkipped
+  // Preconditions: Build has been called
+  // Postconditions: Returns the names of the strands left out because their bases
+  //                 could not be loaded, in strand order
+const vector<string> &SketchCluster::GetSkipped(){
+
+  return m_skipped;
+
+}
+
+  // Name: GetComparisons
+  // Preconditions: Build has been called
+  // Postconditions: Returns how many sketch pairs were compared
+long long SketchCluster::GetComparisons(){
+
+  return m_comparisons;
+
+}
+
+  // Name: WriteClusters
+  // Desc: Writes one TSV row per strand: cluster, strand, representative (first
+  //       strand of the cluster) and the Jaccard and ANI estimates against it
+  // Preconditions: Build has been called with strands
+  // Postconditions: Rows are written in strand order (none for skipped strands)
+void SketchCluster::WriteClusters(ostream &output, vector<Strand*> &strands){
+
+  output << "cluster\tstrand\trepresentative\tjaccard\tani\n";
+
+  for(unsigned int i = 0; i < strands.size(); i++){
+
+    if(m_sketches.at(i).m_skipped){
+
+      continue;
+    }
+
+    int root = FindSet(i);
+
+    double jaccard = (int(i) == root) ? 1.0 : Jaccard(m_sketches.at(i), m_sketches.at(root));
+
+    output << m_cluster.at(i) + 1 << '\t' << strands.at(i)->GetName() << '\t'
+           << strands.at(root)->GetName() << '\t' << jaccard << '\t' << ToANI(jaccard) << '\n';
+  }
+
+}
+
+  // Name: FindSet
+  // Preconditions: 0 <= strand < number of strands
+  // Postconditions: Returns the root of strand's set (with path halving)
+int SketchCluster::FindSet(int strand){
+
+  while(m_parent.at(strand) != strand){
+
+    m_parent.at(strand) = m_parent.at(m_parent.at(strand));
+
+    strand = m_parent.at(strand);
+  }
+
+  return strand;
+
+}
+
+  // Name: JoinSets
+  // Preconditions: Both strands exist
+  // Postconditions: Both strands are in one set, rooted at the lower index
+void SketchCluster::JoinSets(int a, int b){
+
+  a = FindSet(a);
+
+  b = FindSet(b);
+
+  if(a < b){
+
+    m_parent.at(b) = a;
+
+  }else if(b < a){
+
+    m_parent.at(a) = b;
+  }
+
+}
@@ -0,0 +1,98 @@
+//Title: SketchCluster.h
+//Author: Hazael Magino
+//Date: 10/19/2026
+//Description: Similarity clustering of strands with MinHash sketches. Every strand is
+//             reduced to a fixed size one-permutation MinHash sketch of its canonical
+//             k-mers (built in parallel); candidate pairs come from LSH banding of the
+//             sketches, their Jaccard similarity is estimated by comparing sketch bins
+//             with SIMD, and pairs above the ANI threshold are joined with union-find.
+
+#ifndef SKETCHCLUSTER_H
+#define SKETCHCLUSTER_H
+
+#include "Strand.h"
+
+#include <vector>
+#include <string>
+#include <iostream>
+#include <cstdint>
+using namespace std;
+
+const int SKETCH_BINS = 128; //Bins of a one-permutation MinHash sketch
+const int SKETCH_K = 21; //Default k-mer length
+
+struct StrandSketch {
+  uint32_t m_bins[SKETCH_BINS]; //Minimum hash per bin
+  bool m_empty; //Strand has no valid k-mer; never similar to anything
+  bool m_skipped; //The strand's bases could not be loaded; left out of the clusters
+};
+
+class SketchCluster {
+ public:
+  // Name: SketchCluster (constructor)
+  // Desc: Clusters strands whose estimated ANI is at least minANI, using k-mers of length k
+  // Preconditions: 1 <= k <= 32; 0 < minANI <= 1
+  // Postconditions: Creates an empty clustering
+  SketchCluster(double minANI, int k = SKETCH_K);
+  // Name: Build
+  // Desc: Sketches every strand on threads threads, then clusters them
+  // Preconditions: strands hold DNA or mRNA
+  // Postconditions: Every strand has a cluster, except those whose bases could not
+  //                 be loaded (see GetSkipped)
+  void Build(vector<Strand*> &strands, int threads);
+  // Name: Sketch (static)
+  // Desc: Builds the MinHash sketch of the canonical k-mers of size bases.
+  //       K-mers containing anything but A, C, G, T or U are skipped.
+  // Preconditions: 1 <= k <= 32
+  // Postconditions: sketch is filled; empty bins are densified from their neighbours
+  static void Sketch(const char *bases, int size, int k, StrandSketch &sketch);
+  // Name: Jaccard (static)
+  // Desc: Estimates the Jaccard similarity of two k-mer sets from their sketches
+  // Preconditions: Both sketches were built with the same k
+  // Postconditions: Returns the fraction of equal bins (0 if either is empty)
+  static double Jaccard(const StrandSketch &a, const StrandSketch &b);
+  // Name: ToANI
+  // Desc: Converts a Jaccard estimate to average nucleotide identity (Mash distance)
+  // Preconditions: None
+  // Postconditions: Returns ANI in [0, 1]
+  double ToANI(double jaccard);
+  // Name: GetClusterCount
+  // Preconditions: Build has been called
+  // Postconditions: Returns the number of clusters (singletons included)
+  int GetClusterCount();
+  // Name: GetSkipped
+  // Preconditions: Build has been called
+  // Postconditions: Returns the names of the strands left out because their bases
+  //                 could not be loaded, in strand order
+  const vector<string> &GetSkipped();
+  // Name: GetComparisons
+  // Preconditions: Build has been called
+  // Postconditions: Returns how many sketch pairs were compared
+  long long GetComparisons();
+  // Name: WriteClusters
+  // Desc: Writes one TSV row per strand: cluster, strand, representative (first
+  //       strand of the cluster) and the Jaccard and ANI estimates against it
+  // Preconditions: Build has been called with strands
+  // Postconditions: Rows are written in strand order (none for skipped strands)
+  void WriteClusters(ostream &output, vector<Strand*> &strands);
+ private:
+  // Name: FindSet
+  // Preconditions: 0 <= strand < number of strands
+  // Postconditions: Returns the root of strand's set (with path halving)
+  int FindSet(int strand);
+  // Name: JoinSets
+  // Preconditions: Both strands exist
+  // Postconditions: Both strands are in one set, rooted at the lower index
+  void JoinSets(int a, int b);
+  int m_k; //K-mer length
+  double m_minANI; //ANI threshold for joining two strands
+  double m_minJaccard; //Jaccard equivalent of m_minANI
+  vector<StrandSketch> m_sketches; //One sketch per strand
+  vector<int> m_parent; //Union-find parents
+  vector<int> m_cluster; //Cluster number of every strand
+  int m_clusters; //Number of clusters
+  long long m_comparisons; //Sketch pairs compared
+  vector<string> m_skipped; //Strands whose bases could not be loaded
+};
+
+#endif
@@ -16,112 +16,147 @@
 #include <time.h>
 #include <cmath>
 #include <string>
+#include <algorithm>
 #include "Strand.h"
+#include "StrandCache.h"
+#include "FastqFilter.h"
 
 using namespace std;
 
 
 Strand::Strand(){
   // Name: Strand() - Default Constructor
-  // Desc: Used to build a new empty strand (m_head, m_tail = nullptr and size = 0)
+  // Desc: Used to build a new empty strand (no buffer and size = 0)
   // Preconditions: None
   // Postconditions: Creates a new strand with a default name
 
   m_name = "default strand";
 
-  m_head = nullptr;
+  m_buffer = nullptr;
 
-  m_tail = nullptr;
+  m_start = 0;
 
   m_size = 0;
 
+  m_pieces = nullptr;
+
+  m_cache = nullptr;
+
+  m_cacheSlot = -1;
+
+  m_evicted = false;
+
+  m_spillOffset = -1;
+
 }
 
 Strand::Strand(string name){
   // Name: Strand(string) - Overloaded Constructor
   // Desc: Used to build a new empty strand with the name passed
-  //       with m_head, m_tail = nullptr; size = 0;
+  //       with no buffer; size = 0;
   // Preconditions: None
   // Postconditions: Creates a new strand with passed name
 
   m_name = name;
 
-  m_head = nullptr;
+  m_buffer = nullptr;
 
-  m_tail = nullptr;
+  m_start = 0;
 
   m_size = 0;
 
+  m_pieces = nullptr;
+
+  m_cache = nullptr;
+
+  m_cacheSlot = -1;
+
+  m_evicted = false;
+
+  m_spillOffset = -1;
+
 }
 
 Strand::~Strand(){
   // Name: ~Strand() - Destructor
   // Desc: Used to destruct a strand
-  // Preconditions: There is an existing strand with at least one node
-  // Postconditions: Strand is deallocated (including all dynamically allocated nodes)
-  // to have no memory leaks!
+  // Preconditions: There is an existing strand
+  // Postconditions: Strand releases its buffer; the buffer itself is freed once
+  //                 no other strand or slice refers to it
 
-  Node *curr = m_head; //creating new node
+  if(m_cache != nullptr){
 
-  while(curr != nullptr){ 
-    
-    // while loop to delete nodes while keep track of 
-    // where it is in linked list and deallocate memory
+    m_cache->Remove(this);
+  }
 
-    m_head = curr;
+  FreePieces(m_pieces);
 
-    curr = curr ->m_next;
+  m_pieces = nullptr;
 
-    delete m_head;
-  }
+  m_added = nullptr;
 
-  //Default values
+  m_buffer = nullptr;
 
-  m_head = nullptr; 
+  m_start = 0;
 
-  m_tail = nullptr;
-  
   m_size = 0;
 
-
 }
 
 void Strand::InsertEnd(char data){
   // Name: InsertEnd
-  // Desc: Takes in a char. Creates a new node.
-  //       Inserts node at the end of the strand. Increases size.
+  // Desc: Takes in a char. Appends it at the end of the strand. Increases size.
+  //       A strand that shares its buffer copies its range first (copy on write).
   // Preconditions: Requires a strand
   // Postconditions: Strand is larger.
 
-//Create a new node
+  if(!Touch()){
 
-Node *newNode = new Node(); 
+    return;
+  }
 
-// Insert data into that node
+  if(m_pieces != nullptr){
 
-newNode ->m_data = data; 
+    Insert(m_size, string(1, data));
 
-newNode ->m_next = nullptr;
+    return;
+  }
 
-if(m_head == nullptr){// special case (if it is the first node to be created (aka empty linked list)
+  MakeUnique();
 
-  m_head = newNode;
+  m_buffer->push_back(data);
 
-  m_tail = newNode;
+  m_size++;
 
+  Changed();
 
-} else{
+}
 
-  m_tail-> m_next = newNode;
-  
-  m_tail = newNode;
+void Strand::InsertEnd(const string &data){
+  // Name: InsertEnd (string)
+  // Desc: Appends every char of data at the end of the strand in one step
+  // Preconditions: Requires a strand
+  // Postconditions: Strand is larger by data.length()
 
-}
+  if(!Touch()){
+
+    return;
+  }
+
+  if(m_pieces != nullptr){
+
+    Insert(m_size, data);
+
+    return;
+  }
+
+  MakeUnique();
 
-// Increase size of linked list
+  m_buffer->insert(m_buffer->end(), data.begin(), data.end());
 
-m_size++;
+  m_size += data.length();
 
+  Changed();
 
 }
 
@@ -146,74 +181,717 @@ int Strand::GetSize(){
 void Strand::ReverseStrand(){
   // Name: ReverseSequence
   // Preconditions: Reverses the strand
-  // Postconditions: Strand sequence is reversed in place; nothing returned
+  // Postconditions: Strand sequence is reversed in place; nothing returned.
+  //                 Slices sharing the old buffer keep their original bases.
+
+  if(m_size == 0){
 
-  Node *prev = nullptr;
-  Node *curr = m_head;
-  Node *next = nullptr;
+    return;
+  }
 
+  if(!Touch()){
 
-  // Traverse the linked list between nodes
+    return;
+  }
 
-  while(curr != nullptr){
+  // Slices still looking at the old buffer must not see the reversal
 
+  MakeUnique();
 
-    //store the next node before changing the link of the current node
+  reverse(m_buffer->begin(), m_buffer->end());
 
-    next = curr->m_next;
+  Changed();
 
-    //Reverse the link of the current node to point to the previous node.
+}
 
-    curr->m_next = prev;
+char Strand::GetData(int nodeNum){
+  // Name: GetData
+  // Desc: Returns the data at a specific location in the strand.
+  // Preconditions: Requires a DNA sequence
+  // Postconditions: Returns a single char or '\0' when nodeNum is out of range
 
-    //Move the pointers to the next nodes in the list.
+  if((nodeNum < 0) || (nodeNum >= m_size)){ // if the identified base is outside
 
-    prev = curr;
+    return '\0';
+  }
 
-    curr = next;
+  if(!Touch()){
 
+    return '\0';
   }
 
-  // Update the head pointer and tail pointer of the linked list to point to the last node and first node respectively.
+  // An edited strand walks down the piece table instead
+
+  PieceNode *node = m_pieces;
 
-  m_tail = m_head;
+  while(node != nullptr){
 
-  m_head = prev;
+    int before = (node->m_left != nullptr) ? node->m_left->m_total : 0;
+
+    if(nodeNum < before){
+
+      node = node->m_left;
+
+    }else if(nodeNum < before + node->m_length){
+
+      return (*node->m_buffer)[node->m_start + nodeNum - before];
+
+    }else{
+
+      nodeNum -= before + node->m_length;
+
+      node = node->m_right;
+    }
+  }
+
+  return (*m_buffer)[m_start + nodeNum];
 
 }
 
-char Strand::GetData(int nodeNum){
-  // Name: GetData
-  // Desc: Returns the data at a specific location in the strand.
-  //       Iterates to node and returns char.
-  // Preconditions: Requires a DNA sequence
-  // Postconditions: Returns a single char from a node
+const char *Strand::GetBuffer(){
+  // Name: GetBuffer
+  // Desc: Gives direct read access to the bases for bulk processing
+  // Preconditions: Requires a strand
+  // Postconditions: Returns a pointer to GetSize() chars (nullptr when empty)
+
+  if(m_size == 0){
+
+    return nullptr;
+  }
+
+  if(!Touch()){
+
+    return nullptr;
+  }
+
+  // Bulk readers need contiguous bases; edits since the last call are copied once
+
+  if(m_pieces != nullptr){
+
+    Flatten();
+  }
+
+  return m_buffer->data() + m_start;
+
+}
+
+Strand *Strand::Slice(int start, int end){
+  // Name: Slice
+  // Desc: Creates a view of the bases in [start, end) without copying them.
+  //       The slice shares (and keeps alive) this strand's buffer.
+  // Preconditions: 0 <= start <= end <= GetSize()
+  // Postconditions: Returns a new dynamically allocated strand named name[start:end]
+  //                 or nullptr if the range is invalid
+
+  if((start < 0) || (end < start) || (end > m_size)){
+
+    return nullptr;
+  }
+
+  if(!Touch()){
+
+    return nullptr;
+  }
+
+  if(m_pieces != nullptr){
+
+    Flatten();
+  }
+
+  Strand *slice = new Strand(m_name + "[" + to_string(start) + ":" + to_string(end) + "]");
+
+  // Only the reference count changes; no bases are copied
+
+  slice->m_buffer = m_buffer;
+
+  slice->m_start = m_start + start;
+
+  slice->m_size = end - start;
+
+  return slice;
+
+}
+
+Strand *Strand::Share(string name){
+  // Name: Share
+  // Desc: Creates a strand with another name and the same bases without copying
+  //       them (used to collapse duplicate records)
+  // Preconditions: Requires a strand
+  // Postconditions: Returns a new dynamically allocated strand named name that
+  //                 shares this strand's buffer until either one changes
+
+  Strand *copy = Slice(0, m_size);
+
+  if(copy == nullptr){
+
+    return nullptr;
+  }
+
+  copy->m_name = name;
+
+  copy->m_quality = m_quality;
+
+  return copy;
+
+}
+
+bool Strand::Relocate(){
+  // Name: Relocate
+  // Desc: Copies the bases into a new buffer allocated (and first touched) by the
+  //       calling thread, so they live on that thread's NUMA node
+  // Preconditions: Requires a strand
+  // Postconditions: Returns false (and changes nothing) if the buffer is shared
+  //                 with another strand or the strand is empty
+
+  if(m_size == 0){
+
+    return false;
+  }
+
+  if(!Touch()){
+
+    return false;
+  }
+
+  if(m_pieces != nullptr){
+
+    Flatten();
+  }
+
+  // Moving a shared buffer would silently end the sharing
+
+  if(m_buffer.use_count() > 1){
+
+    return false;
+  }
+
+  const char *bases = m_buffer->data() + m_start;
+
+  m_buffer = make_shared<StrandBuffer>(bases, bases + m_size);
+
+  m_start = 0;
+
+  return true;
+
+}
+
+bool Strand::Pin(){
+  // Name: Pin
+  // Desc: Pages the bases in and keeps the cache from evicting them until Unpin.
+  //       Bulk stages pin each strand while they read it so that other threads
+  //       can enforce the memory budget meanwhile.
+  // Preconditions: None
+  // Postconditions: The bases are resident until the matching Unpin; returns
+  //                 false (with nothing to unpin) if the cache could not load them
+
+  return (m_cache == nullptr) || m_cache->Pin(this);
+
+}
+
+void Strand::Unpin(){
+  // Name: Unpin
+  // Desc: Releases a Pin and lets the cache evict unpinned strands to fit its budget
+  // Preconditions: Matches an earlier Pin; the buffer is no longer read
+  // Postconditions: The strand may be evicted again
+
+  if(m_cache != nullptr){
+
+    m_cache->Unpin(this);
+  }
+
+}
+
+void Strand::SetQuality(vector<uint8_t> packed){
+  // Name: SetQuality
+  // Desc: Attaches binned base qualities (2 bits per base, 4 per byte, as made
+  //       by FastqFilter::PackQualities)
+  // Preconditions: packed covers GetSize() bases
+  // Postconditions: HasQuality() is true until the bases change
+
+  m_quality = make_shared<const vector<uint8_t> >(move(packed));
+
+}
+
+bool Strand::HasQuality(){
+  // Name: HasQuality
+  // Preconditions: Requires a strand
+  // Postconditions: Returns true if the strand has qualities (FASTQ input)
+
+  return (m_quality != nullptr);
+
+}
+
+int Strand::GetQuality(int pos){
+  // Name: GetQuality
+  // Desc: Returns the Phred score that the base's quality bin stands for
+  // Preconditions: Requires a strand
+  // Postconditions: Returns the score, or -1 without qualities or out of range
+
+  if((m_quality == nullptr) || (pos < 0) || (pos >= m_size)){
+
+    return -1;
+  }
+
+  return QUALITY_BINS[((*m_quality)[pos / 4] >> (2 * (pos % 4))) & 3];
+
+}
+
+int Strand::Find(const string &pattern, int from){
+  // Name: Find
+  // Desc: Searches the strand for pattern starting at from
+  // Preconditions: Requires a strand
+  // Postconditions: Returns the index of the first match or -1 if not found
+
+  if((from < 0) || (pattern.empty()) || (from + int(pattern.length()) > m_size)){
+
+    return -1;
+  }
+
+  const char *first = GetBuffer();
+
+  const char *last = first + m_size;
+
+  const char *match = search(first + from, last, pattern.begin(), pattern.end());
+
+  if(match == last){
+
+    return -1;
+  }
+
+  return match - first;
+
+}
+
+void Strand::MakeUnique(){
+  // Name: MakeUnique
+  // Desc: Copies this strand's range into a private buffer when the buffer is
+  //       shared or holds bases outside the range (copy on write)
+  // Preconditions: Requires a strand
+  // Postconditions: m_buffer is owned only by this strand and m_start = 0
+
+  // Flattening always produces a private buffer
+
+  if(m_pieces != nullptr){
+
+    Flatten();
+
+    return;
+  }
+
+  if(m_buffer == nullptr){
+
+    m_buffer = make_shared<StrandBuffer>();
+
+    m_start = 0;
+
+    return;
+  }
+
+  if((m_buffer.use_count() == 1) && (m_start == 0) && (int(m_buffer->size()) == m_size)){
+
+    return;
+  }
+
+  const char *first = m_buffer->data() + m_start;
+
+  m_buffer = make_shared<StrandBuffer>(first, first + m_size);
+
+  m_start = 0;
+
+}
+
+
+bool Strand::Insert(int pos, const string &data){
+  // Name: Insert
+  // Desc: Inserts data before position pos in O(log n) pieces. The strand switches
+  //       to a piece table on its first edit; shared bases are never modified.
+  // Preconditions: 0 <= pos <= GetSize()
+  // Postconditions: Returns false (and changes nothing) if pos is out of range
+
+  if((pos < 0) || (pos > m_size)){
+
+    return false;
+  }
+
+  if(data.empty()){
 
+    return true;
+  }
+
+  if(!Touch()){
+
+    return false;
+  }
+
+  if(m_pieces == nullptr){
+
+    StartPieces();
+  }
+
+  // Appending right after the last added bases just grows the rightmost piece
+
+  PieceNode *last = m_pieces;
+
+  while((last != nullptr) && (last->m_right != nullptr)){
+
+    last = last->m_right;
+  }
 
-  Node* currentNode = m_head; // create a pointer Node type variable to traverse linked list
+  if((pos == m_size) && (last != nullptr) && (last->m_buffer == m_added) &&
+     (last->m_start + last->m_length == int(m_added->size()))){
 
-  for (int i = 0; ((i < nodeNum ) && (currentNode != nullptr)); i++){
+    m_added->insert(m_added->end(), data.begin(), data.end());
 
-    if(currentNode == nullptr){ // if the identified node is outside
+    last->m_length += data.length();
 
-      return '\0';
+    for(PieceNode *node = m_pieces; node != nullptr; node = node->m_right){
+
+      node->m_total += data.length();
     }
 
-    currentNode = currentNode->m_next;
+  }else{
+
+    PieceNode *left = nullptr;
+
+    PieceNode *right = nullptr;
+
+    SplitPieces(m_pieces, pos, left, right);
+
+    m_pieces = MergePieces(MergePieces(left, AddPiece(data)), right);
+  }
+
+  m_size += data.length();
+
+  Changed();
+
+  return true;
+
+}
+
+bool Strand::Delete(int pos, int length){
+  // Name: Delete
+  // Desc: Removes length bases starting at pos in O(log n) pieces
+  // Preconditions: 0 <= pos, pos + length <= GetSize()
+  // Postconditions: Returns false (and changes nothing) if the range is invalid
+
+  if((pos < 0) || (length < 0) || (pos + length > m_size)){
+
+    return false;
+  }
+
+  if(length == 0){
+
+    return true;
+  }
+
+  if(!Touch()){
+
+    return false;
+  }
+
+  if(m_pieces == nullptr){
 
+    StartPieces();
   }
 
-  if (currentNode != nullptr){
+  PieceNode *left = nullptr;
 
-    return currentNode -> m_data;
+  PieceNode *middle = nullptr;
+
+  PieceNode *right = nullptr;
+
+  SplitPieces(m_pieces, pos, left, middle);
+
+  SplitPieces(middle, length, middle, right);
+
+  FreePieces(middle);
+
+  m_pieces = MergePieces(left, right);
+
+  m_size -= length;
+
+  if(m_pieces == nullptr){
+
+    // Everything was deleted; go back to an empty contiguous strand
+
+    m_added = nullptr;
+
+    m_start = 0;
+  }
+
+  Changed();
+
+  return true;
+
+}
+
+bool Strand::Replace(int pos, const string &data){
+  // Name: Replace
+  // Desc: Substitutes the bases starting at pos with data (same length)
+  // Preconditions: 0 <= pos, pos + data.length() <= GetSize()
+  // Postconditions: Returns false (and changes nothing) if the range is invalid
+
+  if((pos < 0) || (pos + int(data.length()) > m_size)){
+
+    return false;
+  }
+
+  return Delete(pos, data.length()) && Insert(pos, data);
+
+}
+
+// Counts the nodes of a piece treap
+static int CountPieces(PieceNode *node){
+
+  if(node == nullptr){
+
+    return 0;
+  }
+
+  return 1 + CountPieces(node->m_left) + CountPieces(node->m_right);
+
+}
+
+int Strand::GetPieceCount(){
+  // Name: GetPieceCount
+  // Preconditions: Requires a strand
+  // Postconditions: Returns the number of pieces (0 when the strand is contiguous)
+
+  return CountPieces(m_pieces);
+
+}
+
+// Appends the bases of a piece treap, in order, to output
+static void CopyPieces(PieceNode *node, StrandBuffer &output){
+
+  if(node == nullptr){
+
+    return;
+  }
+
+  CopyPieces(node->m_left, output);
+
+  const char *first = node->m_buffer->data() + node->m_start;
+
+  output.insert(output.end(), first, first + node->m_length);
+
+  CopyPieces(node->m_right, output);
+
+}
+
+void Strand::Flatten(){
+  // Name: Flatten
+  // Desc: Copies the pieces of an edited strand into one contiguous buffer so
+  //       bulk readers (transcription, translation, search) get a plain pointer
+  // Preconditions: Requires a strand
+  // Postconditions: m_pieces is empty and m_buffer holds every base
+
+  shared_ptr<StrandBuffer> flat = make_shared<StrandBuffer>();
+
+  flat->reserve(m_size);
+
+  CopyPieces(m_pieces, *flat);
+
+  FreePieces(m_pieces);
+
+  m_pieces = nullptr;
+
+  m_added = nullptr;
+
+  m_buffer = flat;
+
+  m_start = 0;
+
+}
+
+void Strand::StartPieces(){
+  // Name: StartPieces
+  // Desc: Turns the contiguous range into the first piece of a piece table
+  // Preconditions: m_pieces is empty
+  // Postconditions: m_pieces holds one piece sharing m_buffer (none if empty)
+
+  if(m_size > 0){
+
+    m_pieces = new PieceNode{m_buffer, m_start, m_size, m_size, rand(), nullptr, nullptr};
+  }
+
+  // The piece keeps the buffer alive; the contiguous view is rebuilt by Flatten
+
+  m_buffer = nullptr;
+
+  m_start = 0;
+
+}
+
+PieceNode *Strand::AddPiece(const string &data){
+  // Name: AddPiece
+  // Desc: Appends data to m_added and wraps it in a new piece
+  // Preconditions: data is not empty
+  // Postconditions: Returns a new single node treap
+
+  if(m_added == nullptr){
+
+    m_added = make_shared<StrandBuffer>();
+  }
+
+  int start = m_added->size();
+
+  m_added->insert(m_added->end(), data.begin(), data.end());
+
+  return new PieceNode{m_added, start, int(data.length()), int(data.length()), rand(), nullptr, nullptr};
+
+}
+
+// Recomputes the base count of a node from its piece and subtrees
+static void UpdateTotal(PieceNode *node){
+
+  node->m_total = node->m_length;
+
+  if(node->m_left != nullptr){
+
+    node->m_total += node->m_left->m_total;
+  }
+
+  if(node->m_right != nullptr){
+
+    node->m_total += node->m_right->m_total;
+  }
+
+}
+
+void Strand::SplitPieces(PieceNode *node, int pos, PieceNode *&left, PieceNode *&right){
+  // Name: SplitPieces (static)
+  // Desc: Splits a treap at base pos, cutting a piece in two if pos falls inside it
+  // Preconditions: 0 <= pos <= total bases in node
+  // Postconditions: left holds the first pos bases and right the rest
+
+  if(node == nullptr){
+
+    left = nullptr;
+
+    right = nullptr;
+
+    return;
+  }
+
+  int before = (node->m_left != nullptr) ? node->m_left->m_total : 0;
+
+  if(pos <= before){
+
+    SplitPieces(node->m_left, pos, left, node->m_left);
+
+    right = node;
+
+  }else if(pos >= before + node->m_length){
+
+    SplitPieces(node->m_right, pos - before - node->m_length, node->m_right, right);
+
+    left = node;
 
   }else{
 
-    return '\0'; 
+    // The cut falls inside this piece; the second half takes over the right
+    // subtree and the same priority, so both halves stay valid treaps
+
+    int offset = pos - before;
+
+    PieceNode *tail = new PieceNode{node->m_buffer, node->m_start + offset, node->m_length - offset,
+                                    0, node->m_priority, nullptr, node->m_right};
+
+    node->m_length = offset;
+
+    node->m_right = nullptr;
+
+    UpdateTotal(tail);
+
+    left = node;
+
+    right = tail;
   }
 
+  UpdateTotal(node);
+
 }
 
+PieceNode *Strand::MergePieces(PieceNode *left, PieceNode *right){
+  // Name: MergePieces (static)
+  // Desc: Joins two treaps where every piece of left comes before right
+  // Preconditions: None
+  // Postconditions: Returns the root of the joined treap
+
+  if(left == nullptr){
+
+    return right;
+  }
+
+  if(right == nullptr){
+
+    return left;
+  }
+
+  if(left->m_priority > right->m_priority){
+
+    left->m_right = MergePieces(left->m_right, right);
+
+    UpdateTotal(left);
+
+    return left;
+  }
+
+  right->m_left = MergePieces(left, right->m_left);
+
+  UpdateTotal(right);
+
+  return right;
+
+}
+
+void Strand::FreePieces(PieceNode *node){
+  // Name: FreePieces (static)
+  // Preconditions: None
+  // Postconditions: Every node of the treap is deallocated
+
+  if(node == nullptr){
+
+    return;
+  }
+
+  FreePieces(node->m_left);
+
+  FreePieces(node->m_right);
+
+  delete node;
+
+}
+
+
+bool Strand::Touch(){
+  // Name: Touch
+  // Desc: Marks the strand as used and pages its bases back in if its cache
+  //       evicted them
+  // Preconditions: Called before the bases are read or changed
+  // Postconditions: Returns true if the bases are resident, false if the cache
+  //                 could not load them (the strand is then empty)
+
+  return (m_cache == nullptr) || m_cache->Touch(this);
+
+}
+
+void Strand::Changed(){
+  // Name: Changed
+  // Desc: Tells the cache that the bases changed (new size, stale spill copy)
+  //       and drops qualities that no longer line up with the bases
+  // Preconditions: Called after the bases were changed
+  // Postconditions: The cache's accounting matches the strand
+
+  m_quality = nullptr;
+
+  if(m_cache != nullptr){
+
+    m_cache->Changed(this);
+  }
+
+}
 
 ostream &operator<< (ostream &output, Strand &heapV){
   // Name: operator<<
@@ -223,17 +901,15 @@ ostream &operator<< (ostream &output, Strand &heapV){
   // Preconditions: Requires a strand
   // Postconditions: Returns an output stream (does not cout the output)
 
-  Node* currentNode = heapV.m_head; // start at the head of the linked list
+  const char *bases = heapV.GetBuffer(); // start at the first base of the strand
 
-  while(currentNode != nullptr){
+  for(int i = 0; i < heapV.m_size; i++){
 
-    output << currentNode ->m_data << "->";
-
-    currentNode = currentNode ->m_next;
+    output << bases[i] << "->";
 
   }
 
   output <<"END";
   return output;
 
-}
\ No newline at end of file
+}
@@ -12,38 +12,60 @@
 #include <iostream>
 #include <iomanip>
 #include <cmath>
+#include <memory>
+#include <vector>
+#include <cstdint>
 using namespace std;
 
-struct Node {
-  char m_data;
-  Node *m_next;
+// Bases are kept in one contiguous buffer that is shared (and reference counted)
+// by every strand or slice that views part of it
+typedef vector<char> StrandBuffer;
+
+class StrandCache;
+
+// One piece of an edited strand: m_length bases of m_buffer starting at m_start.
+// Pieces form an implicit treap ordered by position in the strand; m_total is the
+// number of bases in the subtree so an offset can be found in O(log n).
+struct PieceNode {
+  shared_ptr<StrandBuffer> m_buffer; //Original bases or the strand's added bases
+  int m_start; //Offset of the piece in m_buffer
+  int m_length; //Bases in this piece
+  int m_total; //Bases in this piece and both subtrees
+  int m_priority; //Random heap priority that keeps the treap balanced
+  PieceNode *m_left; //Pieces before this one
+  PieceNode *m_right; //Pieces after this one
 };
 
 class Strand {
  public:
   // Name: Strand() - Default Constructor
-  // Desc: Used to build a new empty strand (m_head, m_tail = nullptr and size = 0)
+  // Desc: Used to build a new empty strand (no buffer and size = 0)
   // Preconditions: None
   // Postconditions: Creates a new strand with a default name
   Strand();
   // Name: Strand(string) - Overloaded Constructor
   // Desc: Used to build a new empty strand with the name passed
-  //       with m_head, m_tail = nullptr; size = 0;
+  //       with no buffer; size = 0;
   // Preconditions: None
   // Postconditions: Creates a new strand with passed name
   Strand(string);
   // Name: ~Strand() - Destructor
   // Desc: Used to destruct a strand
-  // Preconditions: There is an existing strand with at least one node
-  // Postconditions: Strand is deallocated (including all dynamically allocated nodes)
-  //                 to have no memory leaks!
+  // Preconditions: There is an existing strand
+  // Postconditions: Strand releases its buffer; the buffer itself is freed once
+  //                 no other strand or slice refers to it
  ~Strand();
   // Name: InsertEnd
-  // Desc: Takes in a char. Creates a new node.
-  //       Inserts node at the end of the strand. Increases size.
+  // Desc: Takes in a char. Appends it at the end of the strand. Increases size.
+  //       A strand that shares its buffer copies its range first (copy on write).
   // Preconditions: Requires a strand
   // Postconditions: Strand is larger.
   void InsertEnd(char data);
+  // Name: InsertEnd (string)
+  // Desc: Appends every char of data at the end of the strand in one step
+  // Preconditions: Requires a strand
+  // Postconditions: Strand is larger by data.length()
+  void InsertEnd(const string &data);
   // Name: GetName()
   // Preconditions: Requires a strand
   // Postconditions: Returns m_name;
@@ -54,14 +76,93 @@ class Strand {
   int GetSize();
   // Name: ReverseSequence
   // Preconditions: Reverses the strand
-  // Postconditions: Strand sequence is reversed in place; nothing returned
+  // Postconditions: Strand sequence is reversed in place; nothing returned.
+  //                 Slices sharing the old buffer keep their original bases.
   void ReverseStrand();
   // Name: GetData
   // Desc: Returns the data at a specific location in the strand.
-  //       Iterates to node and returns char.
   // Preconditions: Requires a DNA sequence
-  // Postconditions: Returns a single char from a node
+  // Postconditions: Returns a single char or '\0' when nodeNum is out of range
   char GetData(int nodeNum);
+  // Name: GetBuffer
+  // Desc: Gives direct read access to the bases for bulk processing
+  // Preconditions: Requires a strand
+  // Postconditions: Returns a pointer to GetSize() chars (nullptr when empty)
+  const char *GetBuffer();
+  // Name: Slice
+  // Desc: Creates a view of the bases in [start, end) without copying them.
+  //       The slice shares (and keeps alive) this strand's buffer.
+  // Preconditions: 0 <= start <= end <= GetSize()
+  // Postconditions: Returns a new dynamically allocated strand named name[start:end]
+  //                 or nullptr if the range is invalid
+  Strand *Slice(int start, int end);
+  // Name: Share
+  // Desc: Creates a strand with another name and the same bases without copying
+  //       them (used to collapse duplicate records)
+  // Preconditions: Requires a strand
+  // Postconditions: Returns a new dynamically allocated strand named name that
+  //                 shares this strand's buffer until either one changes
+  Strand *Share(string name);
+  // Name: Relocate
+  // Desc: Copies the bases into a new buffer allocated (and first touched) by the
+  //       calling thread, so they live on that thread's NUMA node
+  // Preconditions: Requires a strand
+  // Postconditions: Returns false (and changes nothing) if the buffer is shared
+  //                 with another strand or the strand is empty
+  bool Relocate();
+  // Name: Pin
+  // Desc: Pages the bases in and keeps the cache from evicting them until Unpin.
+  //       Bulk stages pin each strand while they read it so that other threads
+  //       can enforce the memory budget meanwhile.
+  // Preconditions: None
+  // Postconditions: The bases are resident until the matching Unpin; returns
+  //                 false (with nothing to unpin) if the cache could not load them
+  bool Pin();
+  // Name: Unpin
+  // Desc: Releases a Pin and lets the cache evict unpinned strands to fit its budget
+  // Preconditions: Matches an earlier Pin; the buffer is no longer read
+  // Postconditions: The strand may be evicted again
+  void Unpin();
+  // Name: SetQuality
+  // Desc: Attaches binned base qualities (2 bits per base, 4 per byte, as made
+  //       by FastqFilter::PackQualities)
+  // Preconditions: packed covers GetSize() bases
+  // Postconditions: HasQuality() is true until the bases change
+  void SetQuality(vector<uint8_t> packed);
+  // Name: HasQuality
+  // Preconditions: Requires a strand
+  // Postconditions: Returns true if the strand has qualities (FASTQ input)
+  bool HasQuality();
+  // Name: GetQuality
+  // Desc: Returns the Phred score that the base's quality bin stands for
+  // Preconditions: Requires a strand
+  // Postconditions: Returns the score, or -1 without qualities or out of range
+  int GetQuality(int pos);
+  // Name: Find
+  // Desc: Searches the strand for pattern starting at from
+  // Preconditions: Requires a strand
+  // Postconditions: Returns the index of the first match or -1 if not found
+  int Find(const string &pattern, int from = 0);
+  // Name: Insert
+  // Desc: Inserts data before position pos in O(log n) pieces. The strand switches
+  //       to a piece table on its first edit; shared bases are never modified.
+  // Preconditions: 0 <= pos <= GetSize()
+  // Postconditions: Returns false (and changes nothing) if pos is out of range
+  bool Insert(int pos, const string &data);
+  // Name: Delete
+  // Desc: Removes length bases starting at pos in O(log n) pieces
+  // Preconditions: 0 <= pos, pos + length <= GetSize()
+  // Postconditions: Returns false (and changes nothing) if the range is invalid
+  bool Delete(int pos, int length);
+  // Name: Replace
+  // Desc: Substitutes the bases starting at pos with data (same length)
+  // Preconditions: 0 <= pos, pos + data.length() <= GetSize()
+  // Postconditions: Returns false (and changes nothing) if the range is invalid
+  bool Replace(int pos, const string &data);
+  // Name: GetPieceCount
+  // Preconditions: Requires a strand
+  // Postconditions: Returns the number of pieces (0 when the strand is contiguous)
+  int GetPieceCount();
   // Name: operator<<
   // Desc: Overloaded << operator to return ostream from strand
   //       Iterates over the entire strand and builds an output stream
@@ -70,10 +171,67 @@ class Strand {
   // Postconditions: Returns an output stream (does not cout the output)
   friend ostream &operator<< (ostream &output, Strand &myStrand);
  private:
+  // Name: MakeUnique
+  // Desc: Copies this strand's range into a private buffer when the buffer is
+  //       shared or holds bases outside the range (copy on write)
+  // Preconditions: Requires a strand
+  // Postconditions: m_buffer is owned only by this strand and m_start = 0
+  void MakeUnique();
+  // Name: Flatten
+  // Desc: Copies the pieces of an edited strand into one contiguous buffer so
+  //       bulk readers (transcription, translation, search) get a plain pointer
+  // Preconditions: Requires a strand
+  // Postconditions: m_pieces is empty and m_buffer holds every base
+  void Flatten();
+  // Name: StartPieces
+  // Desc: Turns the contiguous range into the first piece of a piece table
+  // Preconditions: m_pieces is empty
+  // Postconditions: m_pieces holds one piece sharing m_buffer (none if empty)
+  void StartPieces();
+  // Name: AddPiece
+  // Desc: Appends data to m_added and wraps it in a new piece
+  // Preconditions: data is not empty
+  // Postconditions: Returns a new single node treap
+  PieceNode *AddPiece(const string &data);
+  // Name: SplitPieces (static)
+  // Desc: Splits a treap at base pos, cutting a piece in two if pos falls inside it
+  // Preconditions: 0 <= pos <= total bases in node
+  // Postconditions: left holds the first pos bases and right the rest
+  static void SplitPieces(PieceNode *node, int pos, PieceNode *&left, PieceNode *&right);
+  // Name: MergePieces (static)
+  // Desc: Joins two treaps where every piece of left comes before right
+  // Preconditions: None
+  // Postconditions: Returns the root of the joined treap
+  static PieceNode *MergePieces(PieceNode *left, PieceNode *right);
+  // Name: FreePieces (static)
+  // Preconditions: None
+  // Postconditions: Every node of the treap is deallocated
+  static void FreePieces(PieceNode *node);
+  // Name: Touch
+  // Desc: Marks the strand as used and pages its bases back in if its cache
+  //       evicted them
+  // Preconditions: Called before the bases are read or changed
+  // Postconditions: Returns true if the bases are resident, false if the cache
+  //                 could not load them (the strand is then empty)
+  bool Touch();
+  // Name: Changed
+  // Desc: Tells the cache that the bases changed (new size, stale spill copy)
+  //       and drops qualities that no longer line up with the bases
+  // Preconditions: Called after the bases were changed
+  // Postconditions: The cache's accounting matches the strand
+  void Changed();
+  friend class StrandCache;
   string m_name; //Name of the strand
-  Node *m_head; //Front of the strand
-  Node *m_tail; //End of the strand
+  shared_ptr<StrandBuffer> m_buffer; //Bases, possibly shared with slices
+  int m_start; //Offset of the first base of this strand in m_buffer
   int m_size; //Total size of the strand
+  PieceNode *m_pieces; //Root of the piece table once the strand is edited, else nullptr
+  shared_ptr<StrandBuffer> m_added; //Bases inserted by edits, referenced by pieces
+  StrandCache *m_cache; //Cache that may evict this strand, or nullptr
+  int m_cacheSlot; //Index of this strand in m_cache
+  bool m_evicted; //Bases live only in the cache's spill file (or the input file)
+  long long m_spillOffset; //Offset of an up to date copy in the spill file, or -1
+  shared_ptr<const vector<uint8_t> > m_quality; //Packed quality bins, or nullptr
 };
 
 #endif
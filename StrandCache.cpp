@@ -0,0 +1,640 @@
+// File:    StrandCache.cpp
+// Author:  Hazael Magino
+// Date:    10/19/2026
+// Section: Section 12
+// E-mail:  hazaelm1@umbc.edu
+// Description: CLOCK eviction of strands to a spill file. Every touch sets a strand's
+// reference bit; when the resident bytes are over budget the hand sweeps the slots,
+// clearing set bits and evicting the first strand whose bit is already clear, so
+// strands that keep being used stay resident. A strand that is evicted again without
+// having changed reuses its spill copy instead of being written twice. Strands that
+// were loaded lazily and never changed are not written at all: their record in the
+// input file is the copy.
+
+#include <iostream>
+#include <unistd.h>
+#include <fcntl.h>
+#include "StrandCache.h"
+
+using namespace std;
+
+const unsigned char SPILL_RAW = 0; //Bases stored one per byte
+const unsigned char SPILL_DNA = 1; //A/C/G/T packed 4 per byte
+const unsigned char SPILL_RNA = 2; //A/C/G/U packed 4 per byte
+
+  // Name: StrandCache (constructor)
+  // Desc: Creates a cache that keeps at most budget bytes of bases resident.
+  //       The spill file is an anonymous temporary file removed on exit.
+  // Preconditions: budget >= 0 (0 never evicts; used for lazy loading alone)
+  // Postconditions: Creates an empty cache
+StrandCache::StrandCache(size_t budget){
+
+  m_budget = budget;
+
+  m_resident = 0;
+
+  m_hand = 0;
+
+  m_spill = (budget > 0) ? tmpfile() : nullptr;
+
+  m_spillEnd = 0;
+
+  m_evictions = 0;
+
+  m_reloads = 0;
+
+  m_source = -1;
+
+  m_loads = 0;
+
+  if((budget > 0) && (m_spill == nullptr)){
+
+    cout << "Error creating the spill file; strands will stay in memory" << endl;
+  }
+
+}
+
+  // Name: ~StrandCache (destructor)
+  // Desc: Pages every strand that is still registered back in and detaches it
+  // Preconditions: None
+  // Postconditions: Spill file is closed
+StrandCache::~StrandCache(){
+
+  for(unsigned int i = 0; i < m_slots.size(); i++){
+
+    Strand *strand = m_slots.at(i).m_strand;
+
+    if(strand != nullptr){
+
+      // A strand that cannot be loaded is detached as an empty strand
+
+      if(strand->m_evicted && !Reload(m_slots.at(i))){
+
+        strand->m_evicted = false;
+      }
+
+      strand->m_cache = nullptr;
+    }
+  }
+
+  if(m_spill != nullptr){
+
+    fclose(m_spill);
+  }
+
+  if(m_source >= 0){
+
+    close(m_source);
+  }
+
+}
+
+  // Name: Add
+  // Desc: Registers a strand so it can be evicted. A slice gets its own copy of
+  //       its bases first: evicting a shared buffer would free nothing, and each
+  //       sharer would reload a separate copy.
+  // Preconditions: strand is resident and not registered with a cache
+  // Postconditions: strand owns its buffer and counts against the budget
+void StrandCache::Add(Strand *strand){
+
+  strand->MakeUnique();
+
+  lock_guard<mutex> guard(m_lock);
+
+  int index = m_slots.size();
+
+  if(!m_freeSlots.empty()){
+
+    index = m_freeSlots.back();
+
+    m_freeSlots.pop_back();
+
+  }else{
+
+    m_slots.push_back(CacheSlot());
+  }
+
+  CacheSlot &slot = m_slots.at(index);
+
+  slot.m_strand = strand;
+
+  slot.m_bytes = strand->m_size;
+
+  slot.m_referenced = true;
+
+  slot.m_pins = 0;
+
+  slot.m_lost = false;
+
+  slot.m_hasSource = false;
+
+  strand->m_cache = this;
+
+  strand->m_cacheSlot = index;
+
+  strand->m_evicted = false;
+
+  strand->m_spillOffset = -1;
+
+  m_resident += slot.m_bytes;
+
+}
+
+  // Name: SetSource
+  // Desc: Opens the uncompressed input file that AddLazy records point into
+  // Preconditions: None
+  // Postconditions: Returns false if the file cannot be opened
+bool StrandCache::SetSource(string fileName){
+
+  lock_guard<mutex> guard(m_lock);
+
+  if(m_source >= 0){
+
+    close(m_source);
+  }
+
+  m_source = open(fileName.c_str(), O_RDONLY);
+
+  return (m_source >= 0);
+
+}
+
+  // Name: AddLazy
+  // Desc: Registers an empty strand as an evicted copy of an indexed record
+  // Preconditions: SetSource succeeded; strand is new and not registered
+  // Postconditions: strand has the record's size and is decoded on first use
+void StrandCache::AddLazy(Strand *strand, const IndexEntry &entry){
+
+  Add(strand);
+
+  lock_guard<mutex> guard(m_lock);
+
+  CacheSlot &slot = m_slots.at(strand->m_cacheSlot);
+
+  m_resident -= slot.m_bytes;
+
+  slot.m_bytes = 0;
+
+  slot.m_referenced = false;
+
+  slot.m_hasSource = true;
+
+  slot.m_sourceOffset = entry.m_offset;
+
+  slot.m_sourceLength = entry.m_length;
+
+  strand->m_buffer = nullptr;
+
+  strand->m_start = 0;
+
+  strand->m_size = entry.m_bases;
+
+  strand->m_evicted = true;
+
+}
+
+  // Name: Remove
+  // Desc: Forgets a strand (called when it is deleted)
+  // Preconditions: strand is registered with this cache
+  // Postconditions: strand no longer counts against the budget
+void StrandCache::Remove(Strand *strand){
+
+  lock_guard<mutex> guard(m_lock);
+
+  CacheSlot &slot = m_slots.at(strand->m_cacheSlot);
+
+  m_resident -= slot.m_bytes;
+
+  slot.m_strand = nullptr;
+
+  slot.m_bytes = 0;
+
+  m_freeSlots.push_back(strand->m_cacheSlot);
+
+  strand->m_cache = nullptr;
+
+  strand->m_cacheSlot = -1;
+
+}
+
+  // Name: Touch
+  // Desc: Sets the strand's reference bit and pages it in if it was evicted.
+  //       Safe to call from several threads; it never evicts.
+  // Preconditions: strand is registered with this cache
+  // Postconditions: Returns true if strand is resident, false if its bases could
+  //                 not be loaded (the strand is then left evicted and empty)
+bool StrandCache::Touch(Strand *strand){
+
+  lock_guard<mutex> guard(m_lock);
+
+  CacheSlot &slot = m_slots.at(strand->m_cacheSlot);
+
+  slot.m_referenced = true;
+
+  return !strand->m_evicted || Reload(slot);
+
+}
+
+  // Name: Pin
+  // Desc: Pages the strand in (like Touch) and keeps it from being evicted until
+  //       the matching Unpin, so its buffer stays valid while other threads unpin
+  // Preconditions: strand is registered with this cache
+  // Postconditions: Returns true with strand resident and pinned, or false (and
+  //                 nothing pinned) if its bases could not be loaded (as for Touch)
+bool StrandCache::Pin(Strand *strand){
+
+  lock_guard<mutex> guard(m_lock);
+
+  CacheSlot &slot = m_slots.at(strand->m_cacheSlot);
+
+  slot.m_referenced = true;
+
+  if(strand->m_evicted && !Reload(slot)){
+
+    return false;
+  }
+
+  slot.m_pins++;
+
+  return true;
+
+}
+
+  // Name: Unpin
+  // Desc: Releases a pin, then evicts unpinned strands until the budget holds.
+  //       Lets bulk stages run within the budget one strand at a time, on any
+  //       number of threads, as long as every reader pins what it reads.
+  // Preconditions: strand was pinned; every thread reading a buffer has pinned it
+  // Postconditions: Resident bytes <= budget, unless every resident strand is pinned
+void StrandCache::Unpin(Strand *strand){
+
+  lock_guard<mutex> guard(m_lock);
+
+  m_slots.at(strand->m_cacheSlot).m_pins--;
+
+  Sweep();
+
+}
+
+  // Name: Changed
+  // Desc: Updates the accounting of a strand whose bases changed and drops its
+  //       now stale spill copy
+  // Preconditions: strand is registered with this cache
+  // Postconditions: strand's resident bytes match its size
+void StrandCache::Changed(Strand *strand){
+
+  lock_guard<mutex> guard(m_lock);
+
+  CacheSlot &slot = m_slots.at(strand->m_cacheSlot);
+
+  m_resident = m_resident - slot.m_bytes + strand->m_size;
+
+  slot.m_bytes = strand->m_size;
+
+  slot.m_hasSource = false;
+
+  strand->m_spillOffset = -1;
+
+}
+
+  // Name: Enforce
+  // Desc: Evicts strands with the CLOCK algorithm until the resident bytes fit the
+  //       budget. Buffers returned by GetBuffer of evicted strands become invalid,
+  //       so this is only called between operations, never during a parallel stage.
+  // Preconditions: No other thread is reading strand buffers
+  // Postconditions: Resident bytes <= budget, unless every resident strand is in use
+void StrandCache::Enforce(){
+
+  lock_guard<mutex> guard(m_lock);
+
+  Sweep();
+
+}
+
+  // Name: Sweep
+  // Desc: Runs the CLOCK hand, evicting unpinned strands, until the budget holds
+  // Preconditions: m_lock is held
+  // Postconditions: Resident bytes <= budget, unless every resident strand is pinned
+  //                 or was referenced on both sweeps
+void StrandCache::Sweep(){
+
+  if((m_budget == 0) || (m_spill == nullptr)){
+
+    return;
+  }
+
+  // Two sweeps are enough: the first clears every reference bit
+
+  size_t steps = 0;
+
+  while((m_resident > m_budget) && (steps < 2 * m_slots.size())){
+
+    CacheSlot &slot = m_slots.at(m_hand);
+
+    m_hand = (m_hand + 1) % m_slots.size();
+
+    steps++;
+
+    if((slot.m_strand == nullptr) || slot.m_strand->m_evicted || (slot.m_bytes == 0) || (slot.m_pins > 0)){
+
+      continue;
+    }
+
+    if(slot.m_referenced){
+
+      slot.m_referenced = false;
+
+      continue;
+    }
+
+    Evict(slot);
+  }
+
+}
+
+  // Name: GetBudget
+  // Preconditions: None
+  // Postconditions: Returns the budget in bytes
+size_t StrandCache::GetBudget(){
+
+  return m_budget;
+
+}
+
+  // Name: GetResidentBytes
+  // Preconditions: None
+  // Postconditions: Returns the bytes of bases currently resident
+size_t StrandCache::GetResidentBytes(){
+
+  lock_guard<mutex> guard(m_lock);
+
+  return m_resident;
+
+}
+
+  // Name: GetSpillBytes
+  // Preconditions: None
+  // Postconditions: Returns the size of the spill file
+uint64_t StrandCache::GetSpillBytes(){
+
+  lock_guard<mutex> guard(m_lock);
+
+  return m_spillEnd;
+
+}
+
+  // Name: GetEvictions
+  // Preconditions: None
+  // Postconditions: Returns how many times a strand was evicted
+long long StrandCache::GetEvictions(){
+
+  lock_guard<mutex> guard(m_lock);
+
+  return m_evictions;
+
+}
+
+  // Name: GetReloads
+  // Preconditions: None
+  // Postconditions: Returns how many times a strand was paged back in
+long long StrandCache::GetReloads(){
+
+  lock_guard<mutex> guard(m_lock);
+
+  return m_reloads;
+
+}
+
+  // Name: GetLoads
+  // Preconditions: None
+  // Postconditions: Returns how many strands were decoded from the source file
+long long StrandCache::GetLoads(){
+
+  lock_guard<mutex> guard(m_lock);
+
+  return m_loads;
+
+}
+
+// 2 bit codes of the packed spill encodings (T and U share code 3)
+static int PackedCode(char base){
+
+  switch(base){
+    case 'A': return 0;
+    case 'C': return 1;
+    case 'G': return 2;
+    case 'T': case 'U': return 3;
+    default: return -1;
+  }
+
+}
+
+  // Name: Evict
+  // Desc: Writes the strand to the spill file (unless an up to date copy is there
+  //       already) and releases its bases
+  // Preconditions: m_lock is held; the slot's strand is resident
+  // Postconditions: Returns true if the strand was evicted
+bool StrandCache::Evict(CacheSlot &slot){
+
+  Strand *strand = slot.m_strand;
+
+  if(strand->m_pieces != nullptr){
+
+    strand->Flatten();
+  }
+
+  // An unchanged lazy strand can always be decoded from its record again
+
+  if((strand->m_spillOffset < 0) && !slot.m_hasSource){
+
+    const char *bases = strand->m_buffer->data() + strand->m_start;
+
+    size_t size = strand->m_size;
+
+    // Pack 4 bases a byte when the strand is pure DNA or pure mRNA
+
+    bool hasT = false;
+
+    bool hasU = false;
+
+    bool packable = true;
+
+    for(size_t i = 0; (i < size) && packable; i++){
+
+      packable = (PackedCode(bases[i]) >= 0);
+
+      hasT = hasT || (bases[i] == 'T');
+
+      hasU = hasU || (bases[i] == 'U');
+    }
+
+    packable = packable && !(hasT && hasU);
+
+    vector<unsigned char> record(1 + (packable ? (size + 3) / 4 : size), 0);
+
+    record[0] = packable ? (hasU ? SPILL_RNA : SPILL_DNA) : SPILL_RAW;
+
+    for(size_t i = 0; i < size; i++){
+
+      if(packable){
+
+        record[1 + i / 4] |= PackedCode(bases[i]) << (2 * (i % 4));
+
+      }else{
+
+        record[1 + i] = bases[i];
+      }
+    }
+
+    if(pwrite(fileno(m_spill), record.data(), record.size(), m_spillEnd) != ssize_t(record.size())){
+
+      return false;
+    }
+
+    strand->m_spillOffset = m_spillEnd;
+
+    m_spillEnd += record.size();
+  }
+
+  strand->m_buffer = nullptr;
+
+  strand->m_start = 0;
+
+  strand->m_evicted = true;
+
+  m_resident -= slot.m_bytes;
+
+  slot.m_bytes = 0;
+
+  m_evictions++;
+
+  return true;
+
+}
+
+  // Name: Reload
+  // Desc: Reads an evicted strand back from the spill file, or decodes its record
+  //       from the source file if it has no spill copy
+  // Preconditions: m_lock is held; the slot's strand is evicted
+  // Postconditions: Returns true if the strand is resident; its spill copy stays
+  //                 valid. On a read error (or a source record that no longer
+  //                 matches the index) the error is reported, the strand stays
+  //                 evicted with no bases and false is returned.
+bool StrandCache::Reload(CacheSlot &slot){
+
+  Strand *strand = slot.m_strand;
+
+  // Reported once already; the strand is empty from then on
+
+  if(slot.m_lost){
+
+    return false;
+  }
+
+  size_t size = strand->m_size;
+
+  unsigned char encoding = SPILL_RAW;
+
+  shared_ptr<StrandBuffer> bases = make_shared<StrandBuffer>(size);
+
+  if((strand->m_spillOffset < 0) && slot.m_hasSource){
+
+    vector<char> line(slot.m_sourceLength);
+
+    bool read = (pread(m_source, line.data(), line.size(), slot.m_sourceOffset) == ssize_t(line.size()));
+
+    // The record must still hold exactly the bases the index counted; parsing
+    // stops as soon as it finds more than the buffer holds
+
+    if(!read || (line.size() < size) ||
+       (RecordIndex::ParseRecord(line.data(), line.size(), bases->data(), size) != size)){
+
+      cout << "Error loading " << strand->m_name << " from the input file (was it changed?)" << endl;
+
+      Lose(slot);
+
+      return false;
+    }
+
+    strand->m_buffer = bases;
+
+    strand->m_start = 0;
+
+    strand->m_evicted = false;
+
+    slot.m_bytes = size;
+
+    m_resident += size;
+
+    m_loads++;
+
+    return true;
+  }
+
+  int fd = fileno(m_spill);
+
+  bool read = (pread(fd, &encoding, 1, strand->m_spillOffset) == 1);
+
+  if(read && (encoding == SPILL_RAW)){
+
+    read = (pread(fd, bases->data(), size, strand->m_spillOffset + 1) == ssize_t(size));
+
+  }else if(read){
+
+    vector<unsigned char> packed((size + 3) / 4);
+
+    read = (pread(fd, packed.data(), packed.size(), strand->m_spillOffset + 1) == ssize_t(packed.size()));
+
+    const char *alphabet = (encoding == SPILL_RNA) ? "ACGU" : "ACGT";
+
+    for(size_t i = 0; read && (i < size); i++){
+
+      (*bases)[i] = alphabet[(packed[i / 4] >> (2 * (i % 4))) & 3];
+    }
+  }
+
+  // The strand cannot be rebuilt without its spill copy
+
+  if(!read){
+
+    cout << "Error reading " << strand->m_name << " back from the spill file" << endl;
+
+    Lose(slot);
+
+    return false;
+  }
+
+  strand->m_buffer = bases;
+
+  strand->m_start = 0;
+
+  strand->m_evicted = false;
+
+  slot.m_bytes = size;
+
+  m_resident += size;
+
+  m_reloads++;
+
+  return true;
+
+}
+
+  // Name: Lose
+  // Desc: Gives up on a strand whose bases cannot be loaded. It stays evicted and
+  //       reads as empty, so callers see no bases instead of stale or partial ones.
+  // Preconditions: m_lock is held; the slot's strand is evicted
+  // Postconditions: The strand has no bases and is never reloaded
+void StrandCache::Lose(CacheSlot &slot){
+
+  Strand *strand = slot.m_strand;
+
+  slot.m_lost = true;
+
+  slot.m_hasSource = false;
+
+  strand->m_size = 0;
+
+  strand->m_quality = nullptr;
+
+}
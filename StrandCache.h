@@ -0,0 +1,170 @@
+//Title: StrandCache.h
+//Author: Hazael Magino
+//Date: 10/19/2026
+//Description: Memory budget for loaded strands. Strands registered with the cache
+//             are evicted with the CLOCK algorithm once their bases exceed the
+//             budget: the bases go to a spill file (packed 4 per byte when they
+//             are all A/C/G/T or A/C/G/U) and are paged back in the next time the
+//             strand is read or changed. With a source file set, strands can also
+//             be registered straight from a record index: they start out evicted
+//             and are decoded from the input the first time they are used.
+
+#ifndef STRANDCACHE_H
+#define STRANDCACHE_H
+
+#include "Strand.h"
+#include "RecordIndex.h"
+
+#include <vector>
+#include <mutex>
+#include <cstdio>
+#include <cstdint>
+using namespace std;
+
+struct CacheSlot {
+  Strand *m_strand; //Registered strand, or nullptr for a free slot
+  size_t m_bytes; //Resident bytes counted for the strand (0 while evicted)
+  bool m_referenced; //CLOCK reference bit, set whenever the strand is touched
+  int m_pins; //Threads reading the strand's buffer; a pinned strand is never evicted
+  bool m_lost; //The bases could not be loaded; the strand stays evicted and empty
+  bool m_hasSource; //The record in the source file still holds the strand's bases
+  uint64_t m_sourceOffset; //Offset of the strand's record in the source file
+  uint32_t m_sourceLength; //Bytes in the strand's record
+};
+
+class StrandCache {
+ public:
+  // Name: StrandCache (constructor)
+  // Desc: Creates a cache that keeps at most budget bytes of bases resident.
+  //       The spill file is an anonymous temporary file removed on exit.
+  // Preconditions: budget >= 0 (0 never evicts; used for lazy loading alone)
+  // Postconditions: Creates an empty cache
+  StrandCache(size_t budget);
+  // Name: ~StrandCache (destructor)
+  // Desc: Pages every strand that is still registered back in and detaches it
+  // Preconditions: None
+  // Postconditions: Spill file is closed
+  ~StrandCache();
+  // Name: Add
+  // Desc: Registers a strand so it can be evicted. A slice gets its own copy of
+  //       its bases first: evicting a shared buffer would free nothing, and each
+  //       sharer would reload a separate copy.
+  // Preconditions: strand is resident and not registered with a cache
+  // Postconditions: strand owns its buffer and counts against the budget
+  void Add(Strand *strand);
+  // Name: SetSource
+  // Desc: Opens the uncompressed input file that AddLazy records point into
+  // Preconditions: None
+  // Postconditions: Returns false if the file cannot be opened
+  bool SetSource(string fileName);
+  // Name: AddLazy
+  // Desc: Registers an empty strand as an evicted copy of an indexed record
+  // Preconditions: SetSource succeeded; strand is new and not registered
+  // Postconditions: strand has the record's size and is decoded on first use
+  void AddLazy(Strand *strand, const IndexEntry &entry);
+  // Name: Remove
+  // Desc: Forgets a strand (called when it is deleted)
+  // Preconditions: strand is registered with this cache
+  // Postconditions: strand no longer counts against the budget
+  void Remove(Strand *strand);
+  // Name: Touch
+  // Desc: Sets the strand's reference bit and pages it in if it was evicted.
+  //       Safe to call from several threads; it never evicts.
+  // Preconditions: strand is registered with this cache
+  // Postconditions: Returns true if strand is resident, false if its bases could
+  //                 not be loaded (the strand is then left evicted and empty)
+  bool Touch(Strand *strand);
+  // Name: Pin
+  // Desc: Pages the strand in (like Touch) and keeps it from being evicted until
+  //       the matching Unpin, so its buffer stays valid while other threads unpin
+  // Preconditions: strand is registered with this cache
+  // Postconditions: Returns true with strand resident and pinned, or false (and
+  //                 nothing pinned) if its bases could not be loaded (as for Touch)
+  bool Pin(Strand *strand);
+  // Name: Unpin
+  // Desc: Releases a pin, then evicts unpinned strands until the budget holds.
+  //       Lets bulk stages run within the budget one strand at a time, on any
+  //       number of threads, as long as every reader pins what it reads.
+  // Preconditions: strand was pinned; every thread reading a buffer has pinned it
+  // Postconditions: Resident bytes <= budget, unless every resident strand is pinned
+  void Unpin(Strand *strand);
+  // Name: Changed
+  // Desc: Updates the accounting of a strand whose bases changed and drops its
+  //       now stale spill copy
+  // Preconditions: strand is registered with this cache
+  // Postconditions: strand's resident bytes match its size
+  void Changed(Strand *strand);
+  // Name: Enforce
+  // Desc: Evicts strands with the CLOCK algorithm until the resident bytes fit the
+  //       budget. Buffers returned by GetBuffer of evicted strands become invalid,
+  //       so this is only called between operations, never during a parallel stage.
+  // Preconditions: No other thread is reading strand buffers
+  // Postconditions: Resident bytes <= budget, unless every resident strand is in use
+  void Enforce();
+  // Name: GetBudget
+  // Preconditions: None
+  // Postconditions: Returns the budget in bytes
+  size_t GetBudget();
+  // Name: GetResidentBytes
+  // Preconditions: None
+  // Postconditions: Returns the bytes of bases currently resident
+  size_t GetResidentBytes();
+  // Name: GetSpillBytes
+  // Preconditions: None
+  // Postconditions: Returns the size of the spill file
+  uint64_t GetSpillBytes();
+  // Name: GetEvictions
+  // Preconditions: None
+  // Postconditions: Returns how many times a strand was evicted
+  long long GetEvictions();
+  // Name: GetReloads
+  // Preconditions: None
+  // Postconditions: Returns how many times a strand was paged back in
+  long long GetReloads();
+  // Name: GetLoads
+  // Preconditions: None
+  // Postconditions: Returns how many strands were decoded from the source file
+  long long GetLoads();
+ private:
+  // Name: Sweep
+  // Desc: Runs the CLOCK hand, evicting unpinned strands, until the budget holds
+  // Preconditions: m_lock is held
+  // Postconditions: Resident bytes <= budget, unless every resident strand is pinned
+  //                 or was referenced on both sweeps
+  void Sweep();
+  // Name: Evict
+  // Desc: Writes the strand to the spill file (unless an up to date copy is there
+  //       already) and releases its bases
+  // Preconditions: m_lock is held; the slot's strand is resident
+  // Postconditions: Returns true if the strand was evicted
+  bool Evict(CacheSlot &slot);
+  // Name: Reload
+  // Desc: Reads an evicted strand back from the spill file, or decodes its record
+  //       from the source file if it has no spill copy
+  // Preconditions: m_lock is held; the slot's strand is evicted
+  // Postconditions: Returns true if the strand is resident; its spill copy stays
+  //                 valid. On a read error (or a source record that no longer
+  //                 matches the index) the error is reported, the strand stays
+  //                 evicted with no bases and false is returned.
+  bool Reload(CacheSlot &slot);
+  // Name: Lose
+  // Desc: Gives up on a strand whose bases cannot be loaded. It stays evicted and
+  //       reads as empty, so callers see no bases instead of stale or partial ones.
+  // Preconditions: m_lock is held; the slot's strand is evicted
+  // Postconditions: The strand has no bases and is never reloaded
+  void Lose(CacheSlot &slot);
+  size_t m_budget; //Maximum resident bytes
+  size_t m_resident; //Resident bytes of registered strands
+  vector<CacheSlot> m_slots; //One slot per registered strand
+  vector<int> m_freeSlots; //Slots of removed strands, reused by Add
+  size_t m_hand; //CLOCK hand
+  FILE *m_spill; //Spill file
+  uint64_t m_spillEnd; //Bytes written to the spill file
+  long long m_evictions; //Strands evicted
+  long long m_reloads; //Strands paged back in
+  int m_source; //Descriptor of the source file, or -1
+  long long m_loads; //Strands decoded from the source file
+  mutex m_lock; //Guards everything above
+};
+
+#endif
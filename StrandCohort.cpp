@@ -0,0 +1,510 @@
+// File:    StrandCohort.cpp
+// Author:  Hazael Magino
+// Date:    10/19/2026
+// Section: Section 12
+// E-mail:  hazaelm1@umbc.edu
+// Description: Reference-based delta compression for groups of highly similar strands.
+// The reference is stored once and every other strand is stored as the substitutions,
+// insertions and deletions that turn the reference into it, so a cohort of near-identical genes costs little more than one strand.
+
+#include <string>
+#include <vector>
+#include <functional>
+#include "StrandCohort.h"
+
+using namespace std;
+
+const int RUN_GAP = 2; //Matching bases allowed inside one edit before it is split
+const int ANCHOR = 12; //Matching bases that end an edit
+const int MAX_SHIFT = 64; //Longest substitution, insertion or deletion looked for
+
+  // Name: StrandCohort() - Default Constructor
+  // Desc: Builds an empty cohort; the first strand added becomes the reference
+  // Preconditions: None
+  // Postconditions: Creates an empty cohort
+StrandCohort::StrandCohort(){
+
+}
+
+  // Name: AddStrand
+  // Desc: Encodes a sequence against the reference and stores it as a new member.
+  //       The first sequence added is stored in full as the reference.
+  // Preconditions: sequence holds only nucleotide characters
+  // Postconditions: Cohort has one more member
+void StrandCohort::AddStrand(string name, const string &sequence){
+
+  CohortMember member;
+
+  member.m_name = name;
+
+  member.m_size = sequence.length();
+
+  if(m_members.empty()){
+
+    // The reference is kept in full and has no edits
+
+    m_reference = sequence;
+
+  }else{
+
+    Encode(member, sequence);
+  }
+
+  m_members.push_back(member);
+
+}
+
+  // Name: GetCount
+  // Preconditions: None
+  // Postconditions: Returns the number of members (including the reference)
+int StrandCohort::GetCount(){
+
+  return m_members.size();
+
+}
+
+  // Name: GetName
+  // Preconditions: 0 <= member < GetCount()
+  // Postconditions: Returns the name of the member
+string StrandCohort::GetName(int member){
+
+  return m_members.at(member).m_name;
+
+}
+
+  // Name: GetSize
+  // Preconditions: 0 <= member < GetCount()
+  // Postconditions: Returns the number of bases in the member
+int StrandCohort::GetSize(int member){
+
+  return m_members.at(member).m_size;
+
+}
+
+  // Name: GetData
+  // Desc: Random access to one base of a member. Binary searches the edits for the
+  //       last one starting at or before pos.
+  // Preconditions: 0 <= member < GetCount()
+  // Postconditions: Returns the base at pos or '\0' if pos is out of range
+char StrandCohort::GetData(int member, int pos){
+
+  CohortMember &curr = m_members.at(member);
+
+  if((pos < 0) || (pos >= curr.m_size)){
+
+    return '\0';
+  }
+
+  int e = FindEdit(curr, pos);
+
+  if(e < 0){
+
+    return m_reference[pos];
+  }
+
+  const DeltaEdit &edit = curr.m_edits.at(e);
+
+  int into = pos - edit.m_memberPos;
+
+  int length = EditLength(curr, e);
+
+  if(into < length){
+
+    return curr.m_bases[edit.m_offset + into];
+  }
+
+  // Past the edit's bases the member follows the reference again
+
+  return m_reference[edit.m_pos + edit.m_delete + into - length];
+
+}
+
+  // Name: Decode
+  // Desc: Rebuilds the full sequence of a member
+  // Preconditions: 0 <= member < GetCount()
+  // Postconditions: Returns the member as a plain string
+string StrandCohort::Decode(int member){
+
+  CohortMember &curr = m_members.at(member);
+
+  string sequence;
+
+  sequence.reserve(curr.m_size);
+
+  int ref = 0; // next reference base to copy
+
+  // Copy the reference up to each edit, then the edit's bases
+
+  for(unsigned int e = 0; e < curr.m_edits.size(); e++){
+
+    const DeltaEdit &edit = curr.m_edits.at(e);
+
+    sequence.append(m_reference, ref, edit.m_pos - ref);
+
+    sequence.append(curr.m_bases, edit.m_offset, EditLength(curr, e));
+
+    ref = edit.m_pos + edit.m_delete;
+  }
+
+  sequence.append(m_reference, ref, curr.m_size - sequence.length());
+
+  return sequence;
+
+}
+
+  // Name: TranscribeInto
+  // Desc: Transcribes every member into target (A->U, T->A, C->G, G->C) by
+  //       transcribing the reference once and complementing only the edit runs
+  // Preconditions: target is empty or was filled from this cohort's reference
+  // Postconditions: target gains one mRNA member per member of this cohort
+void StrandCohort::TranscribeInto(StrandCohort &target){
+
+  // Lookup table for the DNA to mRNA complement
+
+  char complement[256] = {0};
+
+  complement[(unsigned char)'A'] = 'U';
+  complement[(unsigned char)'T'] = 'A';
+  complement[(unsigned char)'C'] = 'G';
+  complement[(unsigned char)'G'] = 'C';
+
+  if(target.m_members.empty()){
+
+    target.m_reference = m_reference;
+
+    for(unsigned int i = 0; i < target.m_reference.length(); i++){
+
+      target.m_reference[i] = complement[(unsigned char)m_reference[i]];
+    }
+  }
+
+  for(unsigned int m = 0; m < m_members.size(); m++){
+
+    // The edits do not change; only their bases are complemented
+
+    CohortMember member = m_members.at(m);
+
+    for(unsigned int i = 0; i < member.m_bases.length(); i++){
+
+      member.m_bases[i] = complement[(unsigned char)member.m_bases[i]];
+    }
+
+    target.m_members.push_back(member);
+  }
+
+}
+
+  // Name: Translate
+  // Desc: Splits a member into codons and converts each with convert.
+  //       The reference is converted once per convertKey and cached; members only
+  //       re-convert the codons that their edits touch.
+  // Preconditions: 0 <= member < GetCount(); convertKey identifies convert
+  //                (for example the genetic code it translates with)
+  // Postconditions: codons and aminos hold one entry per complete codon
+void StrandCohort::Translate(int member, vector<string> &codons, vector<string> &aminos,
+                             const function<string(const string &)> &convert, int convertKey){
+
+  const int CODON = 3;
+
+  if(m_refCodons.empty()){
+
+    for(unsigned int i = 0; i + CODON <= m_reference.length(); i += CODON){
+
+      m_refCodons.push_back(m_reference.substr(i, CODON));
+    }
+  }
+
+  vector<string> &refAminos = m_refAminos[convertKey];
+
+  if(refAminos.size() != m_refCodons.size()){
+
+    refAminos.clear();
+
+    for(unsigned int i = 0; i < m_refCodons.size(); i++){
+
+      refAminos.push_back(convert(m_refCodons.at(i)));
+    }
+  }
+
+  CohortMember &curr = m_members.at(member);
+
+  int codonCount = curr.m_size / CODON;
+
+  codons.resize(codonCount);
+
+  aminos.resize(codonCount);
+
+  int e = -1; // last edit starting at or before the codon
+
+  for(int c = 0; c < codonCount; c++){
+
+    int pos = c * CODON;
+
+    while((e + 1 < int(curr.m_edits.size())) && (curr.m_edits.at(e + 1).m_memberPos <= pos)){
+
+      e++;
+    }
+
+    // Work out where the reference stretch holding pos starts, if pos is in one
+
+    int ref = pos;
+
+    if(e >= 0){
+
+      const DeltaEdit &edit = curr.m_edits.at(e);
+
+      int copied = edit.m_memberPos + EditLength(curr, e); // first base after the edit
+
+      ref = (pos >= copied) ? edit.m_pos + edit.m_delete + pos - copied : -1;
+    }
+
+    int copyEnd = (e + 1 < int(curr.m_edits.size())) ? curr.m_edits.at(e + 1).m_memberPos : curr.m_size;
+
+    // A codon copied whole, and in frame, from the reference reuses its cached conversion
+
+    if((ref >= 0) && (ref % CODON == 0) && (pos + CODON <= copyEnd) &&
+       (ref / CODON < int(m_refCodons.size()))){
+
+      codons.at(c) = m_refCodons.at(ref / CODON);
+
+      aminos.at(c) = refAminos.at(ref / CODON);
+
+    }else{
+
+      codons.at(c) = CodonAt(member, pos);
+
+      aminos.at(c) = convert(codons.at(c));
+    }
+  }
+
+}
+
+  // Name: CodonAt
+  // Desc: Reads the three bases of a member starting at pos
+  // Preconditions: pos + 3 <= GetSize(member)
+  // Postconditions: Returns the codon as a string
+string StrandCohort::CodonAt(int member, int pos){
+
+  string codon;
+
+  codon += GetData(member, pos);
+  codon += GetData(member, pos + 1);
+  codon += GetData(member, pos + 2);
+
+  return codon;
+
+}
+
+  // Name: GetMemoryUsage
+  // Desc: Estimates the bytes used by the cohort (reference plus all edit lists)
+  // Preconditions: None
+  // Postconditions: Returns estimated bytes
+size_t StrandCohort::GetMemoryUsage(){
+
+  size_t bytes = sizeof(StrandCohort) + m_reference.capacity();
+
+  for(unsigned int m = 0; m < m_members.size(); m++){
+
+    const CohortMember &member = m_members.at(m);
+
+    bytes += sizeof(CohortMember) + member.m_name.capacity();
+
+    bytes += member.m_edits.capacity() * sizeof(DeltaEdit) + member.m_bases.capacity();
+  }
+
+  return bytes;
+
+}
+
+  // Name: Encode
+  // Desc: Walks sequence and the reference together. At each mismatch it looks for
+  //       the nearest point where both match again for ANCHOR bases, which makes the
+  //       skipped bases a substitution, insertion or deletion. A member whose edits
+  //       would cost more than its bases is stored verbatim as one edit instead.
+  // Preconditions: member has no edits; m_reference is set
+  // Postconditions: member.m_edits and member.m_bases rebuild sequence
+void StrandCohort::Encode(CohortMember &member, const string &sequence){
+
+  int size = sequence.length();
+
+  int refSize = m_reference.length();
+
+  int i = 0; // next base of the member
+
+  int j = 0; // next base of the reference
+
+  while((i < size) && (j < refSize)){
+
+    if(sequence[i] == m_reference[j]){
+
+      i++;
+
+      j++;
+
+      continue;
+    }
+
+    int skipMember = 0;
+
+    int skipRef = 0;
+
+    FindResync(sequence, i, j, skipMember, skipRef);
+
+    AddEdit(member, sequence, i, skipMember, j, skipRef);
+
+    i += skipMember;
+
+    j += skipRef;
+  }
+
+  // Whatever is left of either sequence becomes a trailing insertion or deletion
+
+  if((i < size) || (j < refSize)){
+
+    AddEdit(member, sequence, i, size - i, j, refSize - j);
+  }
+
+  // Unrelated members are cheaper to keep whole
+
+  if(member.m_edits.size() * sizeof(DeltaEdit) + member.m_bases.length() > size_t(size)){
+
+    member.m_edits.assign(1, DeltaEdit{0, refSize, 0, 0});
+
+    member.m_bases = sequence;
+  }
+
+  member.m_edits.shrink_to_fit();
+
+  member.m_bases.shrink_to_fit();
+
+}
+
+  // Name: FindResync
+  // Desc: Finds the smallest skip (skipMember bases of sequence from i, skipRef
+  //       bases of the reference from j) after which the two match again
+  // Preconditions: i < sequence.length(); j < m_reference.length()
+  // Postconditions: Returns false (with a plain substitution skip) if no match
+  //                 is found within MAX_SHIFT bases
+bool StrandCohort::FindResync(const string &sequence, int i, int j, int &skipMember, int &skipRef){
+
+  int size = sequence.length();
+
+  int refSize = m_reference.length();
+
+  // Try every skip of at most shift bases on both sides, fewest stored bases first
+
+  for(int shift = 1; shift <= MAX_SHIFT; shift++){
+
+    for(int k = 0; k <= 2 * shift; k++){
+
+      int a = (k <= shift) ? k : shift; // member bases skipped
+
+      int b = (k <= shift) ? shift : 2 * shift - k; // reference bases skipped
+
+      if((i + a > size) || (j + b > refSize)){
+
+        continue;
+      }
+
+      // Both must match for ANCHOR bases, or both reach their end together
+
+      int length = min(ANCHOR, min(size - i - a, refSize - j - b));
+
+      if((length < ANCHOR) && ((i + a + length < size) || (j + b + length < refSize))){
+
+        continue;
+      }
+
+      if(sequence.compare(i + a, length, m_reference, j + b, length) == 0){
+
+        skipMember = a;
+
+        skipRef = b;
+
+        return true;
+      }
+    }
+  }
+
+  skipMember = min(MAX_SHIFT, size - i);
+
+  skipRef = min(MAX_SHIFT, refSize - j);
+
+  return false;
+
+}
+
+  // Name: AddEdit
+  // Desc: Appends the edit replacing skipRef reference bases at j with skipMember
+  //       bases of sequence at i, joining it to the previous edit when only a few
+  //       matching bases lie between them
+  // Preconditions: The edit starts after the member's last edit
+  // Postconditions: member has the edit
+void StrandCohort::AddEdit(CohortMember &member, const string &sequence, int i, int skipMember,
+                           int j, int skipRef){
+
+  if(!member.m_edits.empty()){
+
+    DeltaEdit &last = member.m_edits.back();
+
+    int end = last.m_pos + last.m_delete; // first reference base after the last edit
+
+    if(j - end <= RUN_GAP){
+
+      // The matching bases in between join the last edit, whose bases end m_bases
+
+      member.m_bases.append(m_reference, end, j - end);
+
+      member.m_bases.append(sequence, i, skipMember);
+
+      last.m_delete = j + skipRef - last.m_pos;
+
+      return;
+    }
+  }
+
+  member.m_edits.push_back(DeltaEdit{j, skipRef, i, int(member.m_bases.length())});
+
+  member.m_bases.append(sequence, i, skipMember);
+
+}
+
+  // Name: FindEdit
+  // Preconditions: 0 <= pos < member.m_size
+  // Postconditions: Returns the last edit starting in the member at or before pos,
+  //                 or -1 if pos comes before every edit
+int StrandCohort::FindEdit(const CohortMember &member, int pos){
+
+  int low = 0;
+
+  int high = member.m_edits.size(); // edits before low start at or before pos
+
+  while(low < high){
+
+    int middle = (low + high) / 2;
+
+    if(member.m_edits.at(middle).m_memberPos <= pos){
+
+      low = middle + 1;
+
+    }else{
+
+      high = middle;
+    }
+  }
+
+  return low - 1;
+
+}
+
+  // Name: EditLength
+  // Preconditions: 0 <= e < member.m_edits.size()
+  // Postconditions: Returns the number of bases the edit inserts
+int StrandCohort::EditLength(const CohortMember &member, int e){
+
+  int end = (e + 1 < int(member.m_edits.size())) ? member.m_edits.at(e + 1).m_offset
+                                                  : int(member.m_bases.length());
+
+  return end - member.m_edits.at(e).m_offset;
+
+}
@@ -0,0 +1,136 @@
+//Title: StrandCohort.h
+//Author: Hazael Magino
+//Date: 10/19/2026
+//Description: Reference-based delta compression for groups of highly similar strands
+//             (the same gene across individuals or breeds). One reference sequence is
+//             stored in full and every other member is stored as substitutions,
+//             insertions and deletions against it.
+
+#ifndef STRANDCOHORT_H
+#define STRANDCOHORT_H
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <map>
+using namespace std;
+
+// One edit against the reference: the m_delete reference bases starting at m_pos
+// are replaced by the member's bases from m_offset up to the next edit's m_offset.
+// A substitution inserts as many bases as it deletes, an insertion deletes none
+// and a deletion inserts none.
+struct DeltaEdit {
+  int m_pos; //First reference base replaced
+  int m_delete; //Reference bases replaced
+  int m_memberPos; //Position in the member of the first inserted base
+  int m_offset; //Start of the inserted bases in CohortMember::m_bases
+};
+
+struct CohortMember {
+  string m_name; //Name of the strand
+  int m_size; //Total size of the strand
+  vector<DeltaEdit> m_edits; //Sorted, non-overlapping edits against the reference
+  string m_bases; //Inserted bases of every edit, back to back
+};
+
+class StrandCohort {
+ public:
+  // Name: StrandCohort() - Default Constructor
+  // Desc: Builds an empty cohort; the first strand added becomes the reference
+  // Preconditions: None
+  // Postconditions: Creates an empty cohort
+  StrandCohort();
+  // Name: AddStrand
+  // Desc: Encodes a sequence against the reference and stores it as a new member.
+  //       The first sequence added is stored in full as the reference.
+  // Preconditions: sequence holds only nucleotide characters
+  // Postconditions: Cohort has one more member
+  void AddStrand(string name, const string &sequence);
+  // Name: GetCount
+  // Preconditions: None
+  // Postconditions: Returns the number of members (including the reference)
+  int GetCount();
+  // Name: GetName
+  // Preconditions: 0 <= member < GetCount()
+  // Postconditions: Returns the name of the member
+  string GetName(int member);
+  // Name: GetSize
+  // Preconditions: 0 <= member < GetCount()
+  // Postconditions: Returns the number of bases in the member
+  int GetSize(int member);
+  // Name: GetData
+  // Desc: Random access to one base of a member. Binary searches the edits for the
+  //       last one starting at or before pos.
+  // Preconditions: 0 <= member < GetCount()
+  // Postconditions: Returns the base at pos or '\0' if pos is out of range
+  char GetData(int member, int pos);
+  // Name: Decode
+  // Desc: Rebuilds the full sequence of a member
+  // Preconditions: 0 <= member < GetCount()
+  // Postconditions: Returns the member as a plain string
+  string Decode(int member);
+  // Name: TranscribeInto
+  // Desc: Transcribes every member into target (A->U, T->A, C->G, G->C) by
+  //       transcribing the reference once and complementing only the edited bases
+  // Preconditions: target is empty or was filled from this cohort's reference
+  // Postconditions: target gains one mRNA member per member of this cohort
+  void TranscribeInto(StrandCohort &target);
+  // Name: Translate
+  // Desc: Splits a member into codons and converts each with convert.
+  //       The reference is converted once per convertKey and cached; members only
+  //       re-convert the codons that their edits touch or shift out of frame.
+  // Preconditions: 0 <= member < GetCount(); convertKey identifies convert
+  //                (for example the genetic code it translates with)
+  // Postconditions: codons and aminos hold one entry per complete codon
+  void Translate(int member, vector<string> &codons, vector<string> &aminos,
+                 const function<string(const string &)> &convert, int convertKey);
+  // Name: GetMemoryUsage
+  // Desc: Estimates the bytes used by the cohort (reference plus all edit lists)
+  // Preconditions: None
+  // Postconditions: Returns estimated bytes
+  size_t GetMemoryUsage();
+ private:
+  // Name: Encode
+  // Desc: Walks sequence and the reference together. At each mismatch it looks for
+  //       the nearest point where both match again for ANCHOR bases, which makes the
+  //       skipped bases a substitution, insertion or deletion. A member whose edits
+  //       would cost more than its bases is stored verbatim as one edit instead.
+  // Preconditions: member has no edits; m_reference is set
+  // Postconditions: member.m_edits and member.m_bases rebuild sequence
+  void Encode(CohortMember &member, const string &sequence);
+  // Name: FindResync
+  // Desc: Finds the smallest skip (skipMember bases of sequence from i, skipRef
+  //       bases of the reference from j) after which the two match again
+  // Preconditions: i < sequence.length(); j < m_reference.length()
+  // Postconditions: Returns false (with a plain substitution skip) if no match
+  //                 is found within MAX_SHIFT bases
+  bool FindResync(const string &sequence, int i, int j, int &skipMember, int &skipRef);
+  // Name: AddEdit
+  // Desc: Appends the edit replacing skipRef reference bases at j with skipMember
+  //       bases of sequence at i, joining it to the previous edit when only a few
+  //       matching bases lie between them
+  // Preconditions: The edit starts after the member's last edit
+  // Postconditions: member has the edit
+  void AddEdit(CohortMember &member, const string &sequence, int i, int skipMember,
+               int j, int skipRef);
+  // Name: FindEdit
+  // Preconditions: 0 <= pos < member.m_size
+  // Postconditions: Returns the last edit starting in the member at or before pos,
+  //                 or -1 if pos comes before every edit
+  int FindEdit(const CohortMember &member, int pos);
+  // Name: EditLength
+  // Preconditions: 0 <= e < member.m_edits.size()
+  // Postconditions: Returns the number of bases the edit inserts
+  int EditLength(const CohortMember &member, int e);
+  // Name: CodonAt
+  // Desc: Reads the three bases of a member starting at pos
+  // Preconditions: pos + 3 <= GetSize(member)
+  // Postconditions: Returns the codon as a string
+  string CodonAt(int member, int pos);
+  string m_reference; //Full sequence of the reference member
+  vector<CohortMember> m_members; //Member 0 is the reference itself
+  vector<string> m_refCodons; //Cached codons of the reference
+  map<int, vector<string> > m_refAminos; //Cached conversions of m_refCodons per convertKey
+};
+
+#endif
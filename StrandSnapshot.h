@@ -0,0 +1,32 @@
+//Title: StrandSnapshot.h
+//Author: Hazael Magino
+//Date: 10/19/2026
+//Description: Immutable view of the loaded DNA strands. The loader publishes a new
+//             snapshot (with atomic_store) every so often while it appends strands;
+//             readers take the current one with atomic_load and keep using it
+//             without locks. A snapshot stays valid for as long as a reader holds it
+//             because strands are never deleted or changed while readers run.
+
+#ifndef STRANDSNAPSHOT_H
+#define STRANDSNAPSHOT_H
+
+#include "Strand.h"
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <functional>
+#include <unordered_map>
+using namespace std;
+
+struct StrandSnapshot {
+  vector<Strand*> m_strands; //Strands loaded when the snapshot was taken
+  vector<int> m_codes; //Genetic code of each strand
+  unordered_map<string, int> m_names; //Strand name -> index of the first strand with it
+  bool m_complete; //Loading had finished; no later snapshot will add strands
+};
+
+// Returns the most recently published snapshot
+typedef function<shared_ptr<const StrandSnapshot>()> SnapshotSource;
+
+#endif
@@ -0,0 +1,476 @@
+// File:    TranslateKernel.cpp
+// Author:  Hazael Magino
+// Date:    10/19/2026
+// Section: Section 12
+// E-mail:  hazaelm1@umbc.edu
+// Description: SIMD codon translation. A block of codons is loaded as raw bytes, each
+// byte is checked and mapped to a 2 bit digit through a low nibble lookup, the first,
+// second and third bases of every codon are gathered into their own register with
+// byte shuffles, and the 6 bit codon index is looked up in the genetic code table.
+// A block holding any invalid base is redone by the scalar kernel so every kernel
+// gives exactly the same output.
+
+#include <cstring>
+#include "TranslateKernel.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define HAVE_X86_KERNELS 1
+#endif
+
+typedef bool (*CodonKernel)(const char *, size_t, const char *, char *);
+
+// Low nibble lookups shared by the SIMD kernels. A byte is a valid base only if it
+// equals NIBBLE_BASE[its low nibble]; unused entries hold a byte whose low nibble
+// differs from the entry's index, so nothing can match them.
+alignas(16) static const unsigned char NIBBLE_BASE[16] = {
+  0xFF, 'A', 0xFF, 'C', 'T', 'U', 0xFF, 'G', 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x00};
+alignas(16) static const unsigned char NIBBLE_DIGIT[16] = {
+  0, 2, 0, 1, 0, 0, 0, 3, 0, 0, 0, 0, 0, 0, 0, 0};
+
+  // Name: BaseDigit
+  // Desc: 2 bit digit of one base in NCBI order (U/T = 0, C = 1, A = 2, G = 3)
+  // Preconditions: None
+  // Postconditions: Returns the digit or 4 if the base is invalid
+static inline unsigned int BaseDigit(char base){
+
+  switch(base){
+    case 'U': case 'T': return 0;
+    case 'C': return 1;
+    case 'A': return 2;
+    case 'G': return 3;
+    default: return 4;
+  }
+
+}
+
+  // Name: TranslateCodonsScalar
+  // Desc: Reference kernel, one codon at a time
+  // Preconditions: Same as TranslateCodons
+  // Postconditions: Same as TranslateCodons
+bool TranslateCodonsScalar(const char *mRNA, size_t codons, const char *table, char *output){
+
+  bool valid = true;
+
+  for(size_t c = 0; c < codons; c++){
+
+    unsigned int first = BaseDigit(mRNA[c * 3]);
+    unsigned int second = BaseDigit(mRNA[c * 3 + 1]);
+    unsigned int third = BaseDigit(mRNA[c * 3 + 2]);
+
+    if((first | second | third) & 4){
+
+      output[c] = 'X';
+
+      valid = false;
+
+    }else{
+
+      output[c] = table[(first << 4) | (second << 2) | third];
+    }
+  }
+
+  return valid;
+
+}
+
+#ifdef HAVE_X86_KERNELS
+
+// Shuffle masks that gather base k of 16 consecutive codons out of the three 16 byte
+// registers holding them (0x80 zeroes a byte so the three results can be ORed)
+struct GatherMasks {
+  alignas(16) unsigned char m_mask[3][3][16];
+  GatherMasks(){
+    for(int k = 0; k < 3; k++){
+      for(int v = 0; v < 3; v++){
+        for(int i = 0; i < 16; i++){
+          int pos = 3 * i + k - 16 * v;
+          m_mask[k][v][i] = ((pos >= 0) && (pos < 16)) ? pos : 0x80;
+        }
+      }
+    }
+  }
+};
+
+static const GatherMasks GATHER;
+
+  // Name: TranslateCodonsSSSE3
+  // Desc: 16 codons (48 bases) per iteration with 128 bit pshufb
+  // Preconditions: Same as TranslateCodons; CPU supports SSSE3
+  // Postconditions: Same as TranslateCodons
+__attribute__((target("ssse3")))
+static bool TranslateCodonsSSSE3(const char *mRNA, size_t codons, const char *table, char *output){
+
+  const __m128i nibbleBase = _mm_load_si128((const __m128i *)NIBBLE_BASE);
+  const __m128i nibbleDigit = _mm_load_si128((const __m128i *)NIBBLE_DIGIT);
+  const __m128i lowNibble = _mm_set1_epi8(0x0F);
+  const __m128i three = _mm_set1_epi8(3);
+  const __m128i quarter[4] = {_mm_loadu_si128((const __m128i *)table),
+                              _mm_loadu_si128((const __m128i *)(table + 16)),
+                              _mm_loadu_si128((const __m128i *)(table + 32)),
+                              _mm_loadu_si128((const __m128i *)(table + 48))};
+
+  bool valid = true;
+
+  size_t c = 0;
+
+  for(; c + 16 <= codons; c += 16){
+
+    const char *block = mRNA + c * 3;
+
+    __m128i digits[3];
+
+    int matched = 0xFFFF;
+
+    for(int v = 0; v < 3; v++){
+
+      __m128i bytes = _mm_loadu_si128((const __m128i *)(block + 16 * v));
+
+      __m128i nibble = _mm_and_si128(bytes, lowNibble);
+
+      matched &= _mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_shuffle_epi8(nibbleBase, nibble)));
+
+      digits[v] = _mm_shuffle_epi8(nibbleDigit, nibble);
+    }
+
+    if(matched != 0xFFFF){
+
+      valid = TranslateCodonsScalar(block, 16, table, output + c) && valid;
+
+      continue;
+    }
+
+    __m128i base[3];
+
+    for(int k = 0; k < 3; k++){
+
+      base[k] = _mm_or_si128(_mm_or_si128(
+                  _mm_shuffle_epi8(digits[0], _mm_load_si128((const __m128i *)GATHER.m_mask[k][0])),
+                  _mm_shuffle_epi8(digits[1], _mm_load_si128((const __m128i *)GATHER.m_mask[k][1]))),
+                  _mm_shuffle_epi8(digits[2], _mm_load_si128((const __m128i *)GATHER.m_mask[k][2])));
+    }
+
+    // Digits are at most 3, so the 16 bit shifts never carry into the next byte
+
+    __m128i index = _mm_or_si128(_mm_or_si128(_mm_slli_epi16(base[0], 4), _mm_slli_epi16(base[1], 2)), base[2]);
+
+    __m128i low = _mm_and_si128(index, lowNibble);
+
+    __m128i high = _mm_and_si128(_mm_srli_epi16(index, 4), three);
+
+    __m128i residues = _mm_setzero_si128();
+
+    for(int q = 0; q < 4; q++){
+
+      __m128i inQuarter = _mm_cmpeq_epi8(high, _mm_set1_epi8(q));
+
+      residues = _mm_or_si128(residues, _mm_and_si128(inQuarter, _mm_shuffle_epi8(quarter[q], low)));
+    }
+
+    _mm_storeu_si128((__m128i *)(output + c), residues);
+  }
+
+  return TranslateCodonsScalar(mRNA + c * 3, codons - c, table, output + c) && valid;
+
+}
+
+  // Name: TranslateCodonsAVX2
+  // Desc: 32 codons (96 bases) per iteration. Two 48 byte blocks go in the two
+  //       128 bit lanes so the lane-local shuffles work exactly as in SSSE3.
+  // Preconditions: Same as TranslateCodons; CPU supports AVX2
+  // Postconditions: Same as TranslateCodons
+__attribute__((target("avx2")))
+static bool TranslateCodonsAVX2(const char *mRNA, size_t codons, const char *table, char *output){
+
+  const __m256i nibbleBase = _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i *)NIBBLE_BASE));
+  const __m256i nibbleDigit = _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i *)NIBBLE_DIGIT));
+  const __m256i lowNibble = _mm256_set1_epi8(0x0F);
+  const __m256i three = _mm256_set1_epi8(3);
+
+  __m256i quarter[4];
+
+  __m256i mask[3][3];
+
+  for(int q = 0; q < 4; q++){
+
+    quarter[q] = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)(table + 16 * q)));
+  }
+
+  for(int k = 0; k < 3; k++){
+
+    for(int v = 0; v < 3; v++){
+
+      mask[k][v] = _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i *)GATHER.m_mask[k][v]));
+    }
+  }
+
+  bool valid = true;
+
+  size_t c = 0;
+
+  for(; c + 32 <= codons; c += 32){
+
+    const char *block = mRNA + c * 3;
+
+    __m256i digits[3];
+
+    unsigned int matched = 0xFFFFFFFF;
+
+    for(int v = 0; v < 3; v++){
+
+      __m256i bytes = _mm256_set_m128i(_mm_loadu_si128((const __m128i *)(block + 48 + 16 * v)),
+                                       _mm_loadu_si128((const __m128i *)(block + 16 * v)));
+
+      __m256i nibble = _mm256_and_si256(bytes, lowNibble);
+
+      matched &= _mm256_movemask_epi8(_mm256_cmpeq_epi8(bytes, _mm256_shuffle_epi8(nibbleBase, nibble)));
+
+      digits[v] = _mm256_shuffle_epi8(nibbleDigit, nibble);
+    }
+
+    if(matched != 0xFFFFFFFF){
+
+      valid = TranslateCodonsScalar(block, 32, table, output + c) && valid;
+
+      continue;
+    }
+
+    __m256i base[3];
+
+    for(int k = 0; k < 3; k++){
+
+      base[k] = _mm256_or_si256(_mm256_or_si256(_mm256_shuffle_epi8(digits[0], mask[k][0]),
+                                                _mm256_shuffle_epi8(digits[1], mask[k][1])),
+                                _mm256_shuffle_epi8(digits[2], mask[k][2]));
+    }
+
+    __m256i index = _mm256_or_si256(_mm256_or_si256(_mm256_slli_epi16(base[0], 4), _mm256_slli_epi16(base[1], 2)), base[2]);
+
+    __m256i low = _mm256_and_si256(index, lowNibble);
+
+    __m256i high = _mm256_and_si256(_mm256_srli_epi16(index, 4), three);
+
+    __m256i residues = _mm256_setzero_si256();
+
+    for(int q = 0; q < 4; q++){
+
+      __m256i inQuarter = _mm256_cmpeq_epi8(high, _mm256_set1_epi8(q));
+
+      residues = _mm256_or_si256(residues, _mm256_and_si256(inQuarter, _mm256_shuffle_epi8(quarter[q], low)));
+    }
+
+    _mm256_storeu_si256((__m256i *)(output + c), residues);
+  }
+
+  return TranslateCodonsScalar(mRNA + c * 3, codons - c, table, output + c) && valid;
+
+}
+
+// Index vectors that gather base k of 64 codons out of 192 bytes: vpermt2b reads
+// positions below 128 from the first two registers, vpermb fills the rest from the third.
+// The nibble lookups are repeated per 128 bit lane for the lane-local vpshufb.
+struct WideGather {
+  alignas(64) unsigned char m_low[3][64];
+  alignas(64) unsigned char m_high[3][64];
+  alignas(64) unsigned char m_nibbleBase[64];
+  alignas(64) unsigned char m_nibbleDigit[64];
+  unsigned long long m_highMask[3];
+  WideGather(){
+    for(int i = 0; i < 64; i++){
+      m_nibbleBase[i] = NIBBLE_BASE[i % 16];
+      m_nibbleDigit[i] = NIBBLE_DIGIT[i % 16];
+    }
+    for(int k = 0; k < 3; k++){
+      m_highMask[k] = 0;
+      for(int i = 0; i < 64; i++){
+        int pos = 3 * i + k;
+        m_low[k][i] = pos & 127;
+        m_high[k][i] = (pos - 128) & 63;
+        if(pos >= 128){
+          m_highMask[k] |= 1ULL << i;
+        }
+      }
+    }
+  }
+};
+
+static const WideGather WIDE_GATHER;
+
+  // Name: TranslateCodonsAVX512
+  // Desc: 64 codons (192 bases) per iteration; vpermb resolves all 64 table
+  //       entries in one instruction
+  // Preconditions: Same as TranslateCodons; CPU supports AVX-512 BW and VBMI
+  // Postconditions: Same as TranslateCodons
+__attribute__((target("avx512f,avx512bw,avx512vbmi")))
+static bool TranslateCodonsAVX512(const char *mRNA, size_t codons, const char *table, char *output){
+
+  const __m512i nibbleBase = _mm512_load_si512((const void *)WIDE_GATHER.m_nibbleBase);
+  const __m512i nibbleDigit = _mm512_load_si512((const void *)WIDE_GATHER.m_nibbleDigit);
+  const __m512i lowNibble = _mm512_set1_epi8(0x0F);
+  const __m512i lookup = _mm512_loadu_si512((const void *)table);
+
+  __m512i low[3];
+
+  __m512i high[3];
+
+  for(int k = 0; k < 3; k++){
+
+    low[k] = _mm512_load_si512((const void *)WIDE_GATHER.m_low[k]);
+
+    high[k] = _mm512_load_si512((const void *)WIDE_GATHER.m_high[k]);
+  }
+
+  bool valid = true;
+
+  size_t c = 0;
+
+  for(; c + 64 <= codons; c += 64){
+
+    const char *block = mRNA + c * 3;
+
+    __m512i digits[3];
+
+    __mmask64 matched = ~0ULL;
+
+    for(int v = 0; v < 3; v++){
+
+      __m512i bytes = _mm512_loadu_si512((const void *)(block + 64 * v));
+
+      __m512i nibble = _mm512_and_si512(bytes, lowNibble);
+
+      matched &= _mm512_cmpeq_epi8_mask(bytes, _mm512_shuffle_epi8(nibbleBase, nibble));
+
+      digits[v] = _mm512_shuffle_epi8(nibbleDigit, nibble);
+    }
+
+    if(matched != ~0ULL){
+
+      valid = TranslateCodonsScalar(block, 64, table, output + c) && valid;
+
+      continue;
+    }
+
+    __m512i base[3];
+
+    for(int k = 0; k < 3; k++){
+
+      base[k] = _mm512_permutex2var_epi8(digits[0], low[k], digits[1]);
+
+      base[k] = _mm512_mask_permutexvar_epi8(base[k], WIDE_GATHER.m_highMask[k], high[k], digits[2]);
+    }
+
+    __m512i index = _mm512_or_si512(_mm512_or_si512(_mm512_slli_epi16(base[0], 4), _mm512_slli_epi16(base[1], 2)), base[2]);
+
+    _mm512_storeu_si512((void *)(output + c), _mm512_maskz_permutexvar_epi8(~0ULL, index, lookup));
+  }
+
+  return TranslateCodonsScalar(mRNA + c * 3, codons - c, table, output + c) && valid;
+
+}
+
+#endif
+
+struct KernelChoice {
+  const char *m_name;
+  CodonKernel m_kernel;
+};
+
+  // Name: FindKernel
+  // Desc: Looks up a kernel by name if the CPU can run it
+  // Preconditions: None
+  // Postconditions: Returns the kernel or a null kernel if unavailable
+static KernelChoice FindKernel(const char *name){
+
+#ifdef HAVE_X86_KERNELS
+  __builtin_cpu_init();
+
+  if((strcmp(name, "avx512vbmi") == 0) && __builtin_cpu_supports("avx512vbmi") &&
+     __builtin_cpu_supports("avx512bw")){
+
+    return {"avx512vbmi", TranslateCodonsAVX512};
+  }
+
+  if((strcmp(name, "avx2") == 0) && __builtin_cpu_supports("avx2")){
+
+    return {"avx2", TranslateCodonsAVX2};
+  }
+
+  if((strcmp(name, "ssse3") == 0) && __builtin_cpu_supports("ssse3")){
+
+    return {"ssse3", TranslateCodonsSSSE3};
+  }
+#endif
+
+  if(strcmp(name, "scalar") == 0){
+
+    return {"scalar", TranslateCodonsScalar};
+  }
+
+  return {nullptr, nullptr};
+
+}
+
+  // Name: BestKernel
+  // Desc: Picks the fastest kernel the CPU supports
+  // Preconditions: None
+  // Postconditions: Returns the chosen kernel
+static KernelChoice BestKernel(){
+
+  const char *preferred[] = {"avx512vbmi", "avx2", "ssse3", "scalar"};
+
+  for(const char *name : preferred){
+
+    KernelChoice choice = FindKernel(name);
+
+    if(choice.m_kernel != nullptr){
+
+      return choice;
+    }
+  }
+
+  return {"scalar", TranslateCodonsScalar};
+
+}
+
+static KernelChoice g_kernel = BestKernel(); //Kernel used by TranslateCodons
+
+  // Name: TranslateCodons
+  // Desc: Translates codons (3 * codons bases of mRNA) with the selected kernel
+  // Preconditions: table has 64 residues in NCBI order; output has room for codons
+  // Postconditions: Returns true if every base was valid; codons holding a base other
+  //                 than A, C, G, T or U are written as 'X' and make it return false
+bool TranslateCodons(const char *mRNA, size_t codons, const char *table, char *output){
+
+  return g_kernel.m_kernel(mRNA, codons, table, output);
+
+}
+
+  // Name: TranslateKernelName
+  // Preconditions: None
+  // Postconditions: Returns the name of the kernel TranslateCodons uses
+const char *TranslateKernelName(){
+
+  return g_kernel.m_name;
+
+}
+
+  // Name: SelectTranslateKernel
+  // Desc: Forces a kernel ("scalar", "ssse3", "avx2" or "avx512vbmi"), for
+  //       benchmarking and for checking the kernels against each other
+  // Preconditions: None
+  // Postconditions: Returns false (and keeps the current kernel) if the name is
+  //                 unknown or the CPU does not support it
+bool SelectTranslateKernel(const char *name){
+
+  KernelChoice choice = FindKernel(name);
+
+  if(choice.m_kernel == nullptr){
+
+    return false;
+  }
+
+  g_kernel = choice;
+
+  return true;
+
+}
@@ -0,0 +1,40 @@
+//Title: TranslateKernel.h
+//Author: Hazael Magino
+//Date: 10/19/2026
+//Description: Bulk codon translation kernels used by the core. Each kernel turns a run
+//             of mRNA codons into one-letter residues through a 64-entry table. The
+//             SIMD kernels map bases to 2 bit digits with pshufb, pack three digits
+//             into a 6 bit codon index per byte and resolve residues with pshufb
+//             (SSSE3, AVX2) or vpermb (AVX-512 VBMI). The fastest kernel the CPU
+//             supports is picked at runtime; the scalar kernel is the reference the
+//             others must match byte for byte.
+
+#ifndef TRANSLATEKERNEL_H
+#define TRANSLATEKERNEL_H
+
+#include <cstddef>
+
+// Name: TranslateCodons
+// Desc: Translates codons (3 * codons bases of mRNA) with the selected kernel
+// Preconditions: table has 64 residues in NCBI order; output has room for codons
+// Postconditions: Returns true if every base was valid; codons holding a base other
+//                 than A, C, G, T or U are written as 'X' and make it return false
+bool TranslateCodons(const char *mRNA, size_t codons, const char *table, char *output);
+// Name: TranslateCodonsScalar
+// Desc: Reference kernel, one codon at a time
+// Preconditions: Same as TranslateCodons
+// Postconditions: Same as TranslateCodons
+bool TranslateCodonsScalar(const char *mRNA, size_t codons, const char *table, char *output);
+// Name: TranslateKernelName
+// Preconditions: None
+// Postconditions: Returns the name of the kernel TranslateCodons uses
+const char *TranslateKernelName();
+// Name: SelectTranslateKernel
+// Desc: Forces a kernel ("scalar", "ssse3", "avx2" or "avx512vbmi"), for
+//       benchmarking and for checking the kernels against each other
+// Preconditions: None
+// Postconditions: Returns false (and keeps the current kernel) if the name is
+//                 unknown or the CPU does not support it
+bool SelectTranslateKernel(const char *name);
+
+#endif
@@ -0,0 +1,334 @@
+// File:    VariantEngine.cpp
+// Author:  Hazael Magino
+// Date:    10/19/2026
+// Section: Section 12
+// E-mail:  hazaelm1@umbc.edu
+// Description: Batch variant application. Variants are grouped by strand name and
+// sorted once when the file is read; applying them is then a single walk over each
+// strand that copies unchanged stretches and splices in alt alleles, so the cost is
+// linear in the strand plus its variants no matter how many variants there are.
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <cstdlib>
+#include <climits>
+#include "VariantEngine.h"
+
+using namespace std;
+
+  // Name: VariantEngine (constructor)
+  // Preconditions: None
+  // Postconditions: Creates an engine with no variants
+VariantEngine::VariantEngine(){
+
+  m_count = 0;
+
+  m_malformed = 0;
+
+}
+
+  // Name: Read
+  // Desc: Reads a tab separated variant file: strand name, 1 based position, ref
+  //       and alt alleles ("-" or "." for an empty allele). Lines starting with #
+  //       are comments. Each strand's variants are sorted by position.
+  // Preconditions: None
+  // Postconditions: Returns false with error set if the file cannot be read;
+  //                 malformed lines are counted and skipped
+bool VariantEngine::Read(string fileName, string &error){
+
+  ifstream inputData(fileName);
+
+  if(!inputData.is_open()){
+
+    error = "error opening " + fileName;
+
+    return false;
+  }
+
+  string line;
+
+  int lineNumber = 0;
+
+  while(getline(inputData, line)){
+
+    lineNumber++;
+
+    if(!line.empty() && (line.back() == '\r')){
+
+      line.pop_back();
+    }
+
+    if(line.empty() || (line[0] == '#')){
+
+      continue;
+    }
+
+    // Split into exactly four tab separated fields
+
+    vector<string> fields;
+
+    size_t start = 0;
+
+    while(fields.size() < 4){
+
+      size_t tab = line.find('\t', start);
+
+      fields.push_back(line.substr(start, tab - start));
+
+      if(tab == string::npos){
+
+        break;
+      }
+
+      start = tab + 1;
+    }
+
+    char *end = nullptr;
+
+    long pos = (fields.size() == 4) ? strtol(fields.at(1).c_str(), &end, 10) : 0;
+
+    // Positions past INT_MAX cannot be in any strand and would wrap in m_pos
+
+    if((fields.size() != 4) || (end == nullptr) || (*end != '\0') || (pos < 1) || (pos > INT_MAX)){
+
+      m_malformed++;
+
+      continue;
+    }
+
+    Variant variant;
+
+    variant.m_pos = pos - 1;
+
+    variant.m_ref = ((fields.at(2) == "-") || (fields.at(2) == ".")) ? "" : fields.at(2);
+
+    variant.m_alt = ((fields.at(3) == "-") || (fields.at(3) == ".")) ? "" : fields.at(3);
+
+    variant.m_line = lineNumber;
+
+    if((variant.m_ref.find_first_not_of("ACGT") != string::npos) ||
+       (variant.m_alt.find_first_not_of("ACGT") != string::npos)){
+
+      m_malformed++;
+
+      continue;
+    }
+
+    m_variants[fields.at(0)].push_back(variant);
+
+    m_count++;
+  }
+
+  // Sorting once here is what lets Apply make a single pass per strand. An
+  // insertion sorts before a substitution at the same position; otherwise file
+  // order is kept.
+
+  for(map<string, vector<Variant> >::iterator it = m_variants.begin(); it != m_variants.end(); it++){
+
+    stable_sort(it->second.begin(), it->second.end(), [](const Variant &a, const Variant &b){
+      return (a.m_pos < b.m_pos) || ((a.m_pos == b.m_pos) && a.m_ref.empty() && !b.m_ref.empty());
+    });
+  }
+
+  return true;
+
+}
+
+  // Name: Apply
+  // Desc: Applies every strand's variants in parallel. Strands that share a name
+  //       all get that name's variants.
+  // Preconditions: Read has succeeded
+  // Postconditions: results holds one entry per strand that has variants, in
+  //                 strand order; new strands are owned by the caller
+void VariantEngine::Apply(vector<Strand*> &strands, int threads, vector<VariantResult> &results){
+
+  vector<const vector<Variant>*> jobs;
+
+  results.clear();
+
+  for(unsigned int i = 0; i < strands.size(); i++){
+
+    map<string, vector<Variant> >::iterator found = m_variants.find(strands.at(i)->GetName());
+
+    if(found != m_variants.end()){
+
+      VariantResult result = {nullptr, int(i), 0, 0, 0, 0};
+
+      results.push_back(result);
+
+      jobs.push_back(&found->second);
+    }
+  }
+
+  threads = max(1, min(threads, int(jobs.size())));
+
+  atomic<unsigned int> next(0);
+
+  // Each worker claims the next strand until none are left
+
+  auto worker = [&](){
+
+    for(unsigned int j = next++; j < jobs.size(); j = next++){
+
+      ApplyToStrand(strands.at(results.at(j).m_source), *jobs.at(j), results.at(j));
+    }
+  };
+
+  vector<thread> pool;
+
+  for(int t = 1; t < threads; t++){
+
+    pool.push_back(thread(worker));
+  }
+
+  worker();
+
+  for(unsigned int t = 0; t < pool.size(); t++){
+
+    pool.at(t).join();
+  }
+
+}
+
+  // Name: GetVariants
+  // Preconditions: None
+  // Postconditions: Returns the sorted variants of the strands named name, or
+  //                 nullptr if there are none
+const vector<Variant> *VariantEngine::GetVariants(string name){
+
+  map<string, vector<Variant> >::iterator found = m_variants.find(name);
+
+  return (found != m_variants.end()) ? &found->second : nullptr;
+
+}
+
+  // Name: GetVariantCount
+  // Preconditions: None
+  // Postconditions: Returns the number of variants read
+int VariantEngine::GetVariantCount(){
+
+  return m_count;
+
+}
+
+  // Name: GetMalformedCount
+  // Preconditions: None
+  // Postconditions: Returns the number of lines Read could not parse
+int VariantEngine::GetMalformedCount(){
+
+  return m_malformed;
+
+}
+
+  // Name: GetUnmatchedNames
+  // Preconditions: None
+  // Postconditions: Returns the names in the variant file that match no strand
+vector<string> VariantEngine::GetUnmatchedNames(vector<Strand*> &strands){
+
+  map<string, bool> seen;
+
+  vector<string> unmatched;
+
+  for(unsigned int i = 0; i < strands.size(); i++){
+
+    seen[strands.at(i)->GetName()] = true;
+  }
+
+  for(map<string, vector<Variant> >::iterator it = m_variants.begin(); it != m_variants.end(); it++){
+
+    if(seen.find(it->first) == seen.end()){
+
+      unmatched.push_back(it->first);
+    }
+  }
+
+  return unmatched;
+
+}
+
+  // Name: ApplyToStrand (static)
+  // Desc: Builds strand with variants applied in one pass. Variants whose ref does
+  //       not match or that overlap an applied variant are skipped and counted.
+  // Preconditions: variants is sorted by position
+  // Postconditions: result is filled; result.m_strand is a new strand, or nullptr
+  //                 if strand's bases could not be loaded
+void VariantEngine::ApplyToStrand(Strand *strand, const vector<Variant> &variants, VariantResult &result){
+
+  // Pinning keeps the buffer valid while other workers unpin (and evict)
+
+  if(!strand->Pin()){
+
+    return;
+  }
+
+  const char *bases = strand->GetBuffer();
+
+  int size = strand->GetSize();
+
+  int cursor = 0; // first base of the source not yet copied
+
+  string sequence;
+
+  sequence.reserve(size);
+
+  for(unsigned int v = 0; v < variants.size(); v++){
+
+    const Variant &variant = variants.at(v);
+
+    int refLength = variant.m_ref.length();
+
+    bool skip = false;
+
+    if(variant.m_pos < cursor){
+
+      result.m_overlapping++;
+
+      skip = true;
+
+    }else if((variant.m_pos + refLength > size) ||
+             (variant.m_ref.compare(0, refLength, bases + variant.m_pos, refLength) != 0)){
+
+      // Positions past the end count as a ref mismatch too
+
+      result.m_mismatched++;
+
+      skip = true;
+    }
+
+    if(skip){
+
+      if(result.m_firstBadLine == 0){
+
+        result.m_firstBadLine = variant.m_line;
+      }
+
+      continue;
+    }
+
+    // Copy the unchanged stretch, then the alt allele in place of the ref
+
+    sequence.append(bases + cursor, variant.m_pos - cursor);
+
+    sequence += variant.m_alt;
+
+    cursor = variant.m_pos + refLength;
+
+    result.m_applied++;
+  }
+
+  if(size > cursor){
+
+    sequence.append(bases + cursor, size - cursor);
+  }
+
+  strand->Unpin();
+
+  result.m_strand = new Strand(strand->GetName() + "+variants");
+
+  result.m_strand->InsertEnd(sequence);
+
+}
@@ -0,0 +1,86 @@
+//Title: VariantEngine.h
+//Author: Hazael Magino
+//Date: 10/19/2026
+//Description: Applies lists of SNPs and indels (VCF-style position, ref and alt
+//             alleles per strand name) onto loaded strands. Each strand's variants
+//             are sorted once and applied in a single linear pass that builds the
+//             new strand, and strands are processed in parallel.
+
+#ifndef VARIANTENGINE_H
+#define VARIANTENGINE_H
+
+#include "Strand.h"
+
+#include <string>
+#include <vector>
+#include <map>
+using namespace std;
+
+struct Variant {
+  int m_pos; //0 based position of the first ref base (insertion point when m_ref is empty)
+  string m_ref; //Bases expected in the strand; empty for a pure insertion
+  string m_alt; //Bases that replace m_ref; empty for a pure deletion
+  int m_line; //Line of the variant file, for error messages
+};
+
+struct VariantResult {
+  Strand *m_strand; //New strand with the variants applied (nullptr if the source could not be loaded)
+  int m_source; //Index of the strand the variants were applied to
+  int m_applied; //Variants applied
+  int m_mismatched; //Variants skipped because m_ref did not match the strand
+  int m_overlapping; //Variants skipped because they overlap an earlier variant
+  int m_firstBadLine; //Line of the first skipped variant, 0 if none
+};
+
+class VariantEngine {
+ public:
+  // Name: VariantEngine (constructor)
+  // Preconditions: None
+  // Postconditions: Creates an engine with no variants
+  VariantEngine();
+  // Name: Read
+  // Desc: Reads a tab separated variant file: strand name, 1 based position, ref
+  //       and alt alleles ("-" or "." for an empty allele). Lines starting with #
+  //       are comments. Each strand's variants are sorted by position.
+  // Preconditions: None
+  // Postconditions: Returns false with error set if the file cannot be read;
+  //                 malformed lines are counted and skipped
+  bool Read(string fileName, string &error);
+  // Name: Apply
+  // Desc: Applies every strand's variants in parallel. Strands that share a name
+  //       all get that name's variants.
+  // Preconditions: Read has succeeded
+  // Postconditions: results holds one entry per strand that has variants, in
+  //                 strand order; new strands are owned by the caller
+  void Apply(vector<Strand*> &strands, int threads, vector<VariantResult> &results);
+  // Name: GetVariants
+  // Preconditions: None
+  // Postconditions: Returns the sorted variants of the strands named name, or
+  //                 nullptr if there are none
+  const vector<Variant> *GetVariants(string name);
+  // Name: GetVariantCount
+  // Preconditions: None
+  // Postconditions: Returns the number of variants read
+  int GetVariantCount();
+  // Name: GetMalformedCount
+  // Preconditions: None
+  // Postconditions: Returns the number of lines Read could not parse
+  int GetMalformedCount();
+  // Name: GetUnmatchedNames
+  // Preconditions: None
+  // Postconditions: Returns the names in the variant file that match no strand
+  vector<string> GetUnmatchedNames(vector<Strand*> &strands);
+  // Name: ApplyToStrand (static)
+  // Desc: Builds strand with variants applied in one pass. Variants whose ref does
+  //       not match or that overlap an applied variant are skipped and counted.
+  // Preconditions: variants is sorted by position
+  // Postconditions: result is filled; result.m_strand is a new strand, or nullptr
+  //                 if strand's bases could not be loaded
+  static void ApplyToStrand(Strand *strand, const vector<Variant> &variants, VariantResult &result);
+ private:
+  map<string, vector<Variant> > m_variants; //Sorted variants per strand name
+  int m_count; //Variants read
+  int m_malformed; //Lines that could not be parsed
+};
+
+#endif
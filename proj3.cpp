@@ -4,8 +4,12 @@
 //Description: This is part of the Transcription and Translation Project in CMSC 202 @ UMBC
 
 #include "Sequencer.h"
+#include "FastqFilter.h"
+#include "TranslateKernel.h"
 #include "Strand.h"
 #include <iostream>
+#include <string>
+#include <thread>
 using namespace std;
 
 //This allows data to be passed when calling the executable
@@ -15,13 +19,166 @@ int main (int argc, char* argv[]) {
     {
       cout << "You are missing a data file." << endl;
       cout << "Expected usage ./proj3 proj3_data1.txt" << endl;
-      cout << "File 1 should be a file with one or more DNA strands" << endl;
+      cout << "File 1 should be a file with one or more DNA strands (may be gzip/BGZF compressed)" << endl;
+      cout << "Options: --compress  store strands delta-encoded against the first strand" << endl;
+      cout << "         --profile out.tsv  write a codon usage matrix instead of showing the menu" << endl;
+      cout << "         --cluster out.tsv  write MinHash similarity clusters instead of showing the menu" << endl;
+      cout << "         --cluster-ani X  estimated ANI needed to share a cluster (default 0.95)" << endl;
+      cout << "         --serve path.sock  load once and serve requests on a Unix socket" << endl;
+      cout << "         --code N  NCBI genetic code to translate with (default 1, standard)" << endl;
+      cout << "         --strand-code NAME=N  genetic code for one strand" << endl;
+      cout << "         --threads N  threads for parallel stages (default: all cores)" << endl;
+      cout << "         --no-numa    do not partition parallel stages by NUMA node or pin threads" << endl;
+      cout << "         --shard out.fa  transcribe and translate in worker processes, proteins to out.fa" << endl;
+      cout << "         --shards N  worker processes for --shard (default: all cores)" << endl;
+      cout << "         --shard-by range|hash  split records by byte range (default) or name hash" << endl;
+      cout << "         --batch out.fa  stream records to proteins in out.fa, resuming from out.fa.ckpt" << endl;
+      cout << "         --checkpoint-interval S  seconds between --batch checkpoints (default 5)" << endl;
+      cout << "         --variants file.tsv  apply SNPs/indels (name, 1 based pos, ref, alt) as new strands (menu only)" << endl;
+      cout << "         --memory-budget SIZE  bytes of strands kept in memory (K/M/G suffix); the rest" << endl;
+      cout << "                      is spilled to disk and paged back in when used" << endl;
+      cout << "         --lazy       index the file (reusing FILE.idx) and decode strands when first used" << endl;
+      cout << "         --dedup      records with identical bases share one buffer" << endl;
+      cout << "FASTQ input (detected from a leading '@') is quality trimmed and filtered as it is read:" << endl;
+      cout << "         --trim-window N  bases in the sliding quality window (1-128, default 4)" << endl;
+      cout << "         --trim-quality Q  trim the 3' end once a window's mean quality drops below Q (default 20)" << endl;
+      cout << "         --min-length N  drop reads shorter than N bases after trimming (default 30)" << endl;
+      cout << "         --adapter SEQ|none  3' adapter to clip (default AGATCGGAAGAGC)" << endl;
+      cout << "         --max-base-fraction X  drop reads where one base is more than X of the bases (default 0.8)" << endl;
+      cout << "         --kernel K   translation kernel: scalar, ssse3, avx2 or avx512vbmi" << endl;
+      cout << "                      (default: fastest the CPU supports)" << endl;
     }
   else
     {
       cout << endl << "***Transcription and Translation***" << endl << endl;
       Sequencer D = Sequencer(argv[1]); //Passes the file name into the Sequencer constructor
-      D.StartSequencing();//Starts the sequencer
+      string profileFile = "";
+      string socketPath = "";
+      string shardFile = "";
+      string batchFile = "";
+      string clusterFile = "";
+      string variantFile = "";
+      int shards = thread::hardware_concurrency();
+      bool shardByHash = false;
+      FastqSettings fastq;
+      D.SetThreads(thread::hardware_concurrency());
+      for (int i = 2; i < argc; i++)
+        {
+          string option = argv[i];
+          if (option == "--compress")
+            D.SetCompression(true);
+          else if (option == "--lazy")
+            D.SetLazy(true);
+          else if (option == "--dedup")
+            D.SetDedup(true);
+          else if (option == "--no-numa")
+            D.SetNuma(false);
+          else if ((option == "--profile") && (i + 1 < argc))
+            profileFile = argv[++i];
+          else if ((option == "--serve") && (i + 1 < argc))
+            socketPath = argv[++i];
+          else if ((option == "--code") && (i + 1 < argc))
+            {
+              if (!D.SetGeneticCode(atoi(argv[++i])))
+                cout << "Unknown genetic code " << argv[i] << "; using the standard code" << endl;
+            }
+          else if ((option == "--strand-code") && (i + 1 < argc))
+            {
+              string setting = argv[++i];
+              size_t equals = setting.rfind('=');
+              if ((equals == string::npos) || !D.SetStrandCode(setting.substr(0, equals), atoi(setting.substr(equals + 1).c_str())))
+                cout << "Ignoring --strand-code " << setting << " (expected NAME=N with a valid code)" << endl;
+            }
+          else if ((option == "--threads") && (i + 1 < argc))
+            D.SetThreads(atoi(argv[++i]));
+          else if ((option == "--shard") && (i + 1 < argc))
+            shardFile = argv[++i];
+          else if ((option == "--shards") && (i + 1 < argc))
+            shards = atoi(argv[++i]);
+          else if ((option == "--shard-by") && (i + 1 < argc))
+            shardByHash = (string(argv[++i]) == "hash");
+          else if ((option == "--batch") && (i + 1 < argc))
+            batchFile = argv[++i];
+          else if ((option == "--checkpoint-interval") && (i + 1 < argc))
+            D.SetCheckpointInterval(atoi(argv[++i]));
+          else if ((option == "--cluster") && (i + 1 < argc))
+            clusterFile = argv[++i];
+          else if ((option == "--cluster-ani") && (i + 1 < argc))
+            {
+              if (!D.SetClusterANI(atof(argv[++i])))
+                cout << "Ignoring --cluster-ani " << argv[i] << " (expected a value in (0, 1])" << endl;
+            }
+          else if ((option == "--variants") && (i + 1 < argc))
+            {
+              variantFile = argv[++i];
+              D.SetVariantFile(variantFile);
+            }
+          else if ((option == "--memory-budget") && (i + 1 < argc))
+            {
+              char *unit = nullptr;
+              double bytes = strtod(argv[++i], &unit);
+              if ((*unit == 'K') || (*unit == 'k'))
+                bytes *= 1024;
+              else if ((*unit == 'M') || (*unit == 'm'))
+                bytes *= 1024 * 1024;
+              else if ((*unit == 'G') || (*unit == 'g'))
+                bytes *= 1024.0 * 1024 * 1024;
+              D.SetMemoryBudget(size_t(bytes));
+            }
+          else if ((option == "--trim-window") && (i + 1 < argc))
+            {
+              int window = atoi(argv[++i]);
+              if ((window >= 1) && (window <= 128))
+                fastq.m_window = window;
+              else
+                cout << "Ignoring --trim-window " << argv[i] << " (expected 1 to 128)" << endl;
+            }
+          else if ((option == "--trim-quality") && (i + 1 < argc))
+            fastq.m_minQuality = atoi(argv[++i]);
+          else if ((option == "--min-length") && (i + 1 < argc))
+            fastq.m_minLength = atoi(argv[++i]);
+          else if ((option == "--adapter") && (i + 1 < argc))
+            {
+              fastq.m_adapter = argv[++i];
+              if (fastq.m_adapter == "none")
+                fastq.m_adapter = "";
+            }
+          else if ((option == "--max-base-fraction") && (i + 1 < argc))
+            fastq.m_maxBaseFraction = atof(argv[++i]);
+          else if ((option == "--kernel") && (i + 1 < argc))
+            {
+              if (!SelectTranslateKernel(argv[++i]))
+                {
+                  cout << "Kernel " << argv[i] << " is not available; using "
+                       << TranslateKernelName() << endl;
+                }
+            }
+          else
+            cout << "Ignoring unknown option " << option << endl;
+        }
+      // Variants are only applied when the menu loads the file, so the other
+      // modes would silently run on the unvaried strands
+      if ((variantFile != "") && ((socketPath != "") || (shardFile != "") || (batchFile != "")
+                                  || (clusterFile != "") || (profileFile != "")))
+        {
+          cout << "--variants only applies to the menu and cannot be used with "
+               << "--serve, --shard, --batch, --cluster or --profile" << endl;
+          return 1;
+        }
+      D.SetShards(shards, shardByHash);
+      D.SetFastqSettings(fastq);
+      if (socketPath != "")
+        D.Serve(socketPath);//Stays resident and answers socket requests
+      else if (shardFile != "")
+        D.Shard(shardFile);//Runs the whole file through worker processes
+      else if (batchFile != "")
+        D.Batch(batchFile);//Streams the file with checkpoints
+      else if (clusterFile != "")
+        D.ClusterStrands(clusterFile);//Clusters the strands instead of the menu
+      else if (profileFile != "")
+        D.ProfileCodons(profileFile);//Profiles codon usage instead of the menu
+      else
+        D.StartSequencing();//Starts the sequencer
     }
   return 0;
 }
@@ -0,0 +1,121 @@
+// File:    KernelTest.cpp
+// Author:  Hazael Magino
+// Date:    10/19/2026
+// Section: Section 12
+// E-mail:  hazaelm1@umbc.edu
+// Description: Checks every SIMD translation kernel the CPU supports against the scalar
+// kernel. Random mRNA (with some invalid bytes mixed in) of random lengths and
+// alignments is translated under every NCBI genetic code; the residues and the
+// valid flag must match byte for byte. Run with make test.
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <random>
+#include "../SequencerCore.h"
+#include "../TranslateKernel.h"
+
+using namespace std;
+
+const int ROUNDS = 2000; //Random inputs per genetic code
+const int MAX_CODONS = 300; //Longest random input, in codons
+const int MAX_SHIFT = 64; //Inputs start up to this many bytes into the buffer
+
+  // Name: Translate
+  // Desc: Translates bases with one kernel under one genetic code
+  // Preconditions: kernel is available
+  // Postconditions: Returns the residues followed by the core's return code
+string Translate(const char *kernel, const char *bases, size_t length, int code){
+
+  SelectTranslateKernel(kernel);
+
+  vector<char> buffer(length / 3 + 1);
+
+  OutputSpan output = {buffer.data(), buffer.size(), 0};
+
+  int status = CoreTranslate(BaseSpan{bases, length}, output, code);
+
+  return string(output.m_data, output.m_length) + " " + to_string(status);
+
+}
+
+int main(){
+
+  const char *kernels[] = {"ssse3", "avx2", "avx512vbmi"};
+
+  const char BASES[] = "ACGUT";
+
+  const char INVALID[] = {'N', 'a', 'u', '\0', char(0xFF), 'X', '-'};
+
+  mt19937 random(202);
+
+  int failures = 0;
+
+  for(const char *kernel : kernels){
+
+    if(!SelectTranslateKernel(kernel)){
+
+      cout << kernel << ": not supported by this CPU, skipped" << endl;
+
+      continue;
+    }
+
+    long long checked = 0;
+
+    for(int code : GENETIC_CODE_IDS){
+
+      for(int round = 0; round < ROUNDS; round++){
+
+        int shift = random() % MAX_SHIFT;
+
+        size_t length = random() % (MAX_CODONS * 3 + 3);
+
+        string buffer(shift + length, 'A');
+
+        // About one input in four holds an invalid byte somewhere
+
+        bool dirty = (random() % 4 == 0);
+
+        for(size_t i = 0; i < length; i++){
+
+          bool invalid = dirty && (random() % 50 == 0);
+
+          buffer[shift + i] = invalid ? INVALID[random() % sizeof(INVALID)] : BASES[random() % 5];
+        }
+
+        const char *bases = buffer.data() + shift;
+
+        string expected = Translate("scalar", bases, length, code);
+
+        string actual = Translate(kernel, bases, length, code);
+
+        checked++;
+
+        if(actual != expected){
+
+          if(failures < 10){
+
+            cout << kernel << ": mismatch with code " << code << " on " << length / 3
+                 << " codon(s) at shift " << shift << endl;
+          }
+
+          failures++;
+        }
+      }
+    }
+
+    cout << kernel << ": " << checked << " input(s) checked against scalar" << endl;
+  }
+
+  if(failures > 0){
+
+    cout << failures << " mismatch(es)" << endl;
+
+    return 1;
+  }
+
+  cout << "All kernels match scalar" << endl;
+
+  return 0;
+
+}